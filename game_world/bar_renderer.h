@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Health and progress bars rendered into caller buffers
+ *
+ * A bar is '[', then `width` cells, then ']'. The first cells are full blocks
+ * (U+2588 '█'), in proportion current / max, and the rest are light shade
+ * (U+2591 '░'). Both glyphs are three bytes of UTF-8.
+ *
+ * RUNS holds RUN_CELLS full blocks followed by RUN_CELLS light shades. A bar
+ * with `filled` cells is the `width` cells starting at RUN_CELLS - filled, so a
+ * bar up to RUN_CELLS wide is one copy. Nothing allocates and nothing
+ * goes through a stream; wider bars are copied a run at a time.
+ *
+ * Also builds with the sessions' C++17 (Session 1's displayBar uses it).
+ */
+namespace bars {
+
+constexpr size_t GLYPH_BYTES = 3;
+constexpr size_t RUN_CELLS = 64;
+
+struct GlyphRuns {
+    char bytes[2 * RUN_CELLS * GLYPH_BYTES];
+
+    const char* full() const { return bytes; }
+    const char* empty() const { return bytes + RUN_CELLS * GLYPH_BYTES; }
+};
+
+constexpr GlyphRuns makeGlyphRuns() {
+    GlyphRuns runs{};
+    for (size_t cell = 0; cell < 2 * RUN_CELLS; ++cell) {
+        char* glyph = runs.bytes + cell * GLYPH_BYTES;
+        glyph[0] = '\xE2';
+        glyph[1] = '\x96';
+        glyph[2] = cell < RUN_CELLS ? '\x88' : '\x91';
+    }
+    return runs;
+}
+
+inline constexpr GlyphRuns RUNS = makeGlyphRuns();
+
+// Full cells for current out of max, clamped to [0, width]; a max of 0 or less gives none
+constexpr int filledCells(int current, int max, int width) {
+    if (width <= 0 || max <= 0 || current <= 0) {
+        return 0;
+    }
+    if (current >= max) {
+        return width;
+    }
+    // A 32-bit divide when the product fits (any real health value); a 64-bit one costs
+    // several times as much
+    auto product = static_cast<uint64_t>(current) * static_cast<uint64_t>(width);
+    if (product <= UINT32_MAX) {
+        return static_cast<int>(static_cast<uint32_t>(product) / static_cast<uint32_t>(max));
+    }
+    return static_cast<int>(product / static_cast<uint64_t>(max));
+}
+
+// Bytes renderBar() writes for a bar this wide
+constexpr size_t barBytes(int width) {
+    return 2 + static_cast<size_t>(std::max(width, 0)) * GLYPH_BYTES;
+}
+
+// Copies n bytes as 16-byte pieces, the last one overlapping the one before. When it can
+// see that out is a local buffer (a bar on the caller's stack), GCC merges copies of a
+// known size into `rep movs`, which takes longer to start than this takes to finish; the
+// empty asm hides where out points.
+inline void copyBytes(char* out, const char* from, size_t n) {
+#if defined(__GNUC__)
+    asm("" : "+r"(out));
+#endif
+    if (n < 16) {
+        std::memcpy(out, from, n);
+        return;
+    }
+    for (size_t i = 0; i + 16 < n; i += 16) {
+        std::memcpy(out + i, from + i, 16);
+    }
+    std::memcpy(out + n - 16, from + n - 16, 16);
+}
+
+// Copies `cells` glyphs of one run, a run at a time
+inline char* copyCells(char* out, const char* run, size_t cells) {
+    for (; cells > RUN_CELLS; cells -= RUN_CELLS) {
+        std::memcpy(out, run, RUN_CELLS * GLYPH_BYTES);
+        out += RUN_CELLS * GLYPH_BYTES;
+    }
+    std::memcpy(out, run, cells * GLYPH_BYTES);
+    return out + cells * GLYPH_BYTES;
+}
+
+// Writes the bar (barBytes(width) bytes, no terminator) and returns the end
+inline char* renderBar(char* out, int current, int max, int width) {
+    auto cells = static_cast<size_t>(std::max(width, 0));
+    auto filled = static_cast<size_t>(filledCells(current, max, width));
+    *out++ = '[';
+    if (cells <= RUN_CELLS) {
+        copyBytes(out, RUNS.full() + (RUN_CELLS - filled) * GLYPH_BYTES, cells * GLYPH_BYTES);
+        out += cells * GLYPH_BYTES;
+    } else {
+        out = copyCells(out, RUNS.full(), filled);
+        out = copyCells(out, RUNS.empty(), cells - filled);
+    }
+    *out++ = ']';
+    return out;
+}
+
+struct Bar {
+    int current;
+    int max;
+};
+
+// Bytes renderBars() writes for count bars this wide, each with a separator
+constexpr size_t batchBytes(size_t count, int width) { return count * (barBytes(width) + 1); }
+
+// Renders count bars of one width back to back, each followed by separator, and returns the
+// end. out needs batchBytes(count, width) bytes.
+inline char* renderBars(char* out, const Bar* bars, size_t count, int width,
+                        char separator = '\n') {
+    for (size_t i = 0; i < count; ++i) {
+        out = renderBar(out, bars[i].current, bars[i].max, width);
+        *out++ = separator;
+    }
+    return out;
+}
+
+}  // namespace bars
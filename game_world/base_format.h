@@ -0,0 +1,121 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    include <emmintrin.h>
+#    define CPP_QUEST_HAS_SSE2_HEX 1
+#endif
+
+/**
+ * Integers in decimal, hex and octal, written into caller buffers
+ *
+ * format() writes one value with std::to_chars: no stream, no locale, no
+ * base flags to set and reset. formatAll() writes a whole array, each value
+ * followed by a separator, into one buffer; for hex it turns each 32- or
+ * 64-bit value into all of its digits at once in an SSE2 register (nibbles
+ * spread to bytes, then '0'-'9'/'a'-'f' by compare and add) and keeps the
+ * significant ones.
+ *
+ * Hex and octal show a negative value's two's-complement bits, as std::hex
+ * and std::oct do. Digits are lowercase, with no prefix.
+ *
+ * Also builds with the sessions' C++17 (Session 1's displayInBases uses it).
+ */
+namespace bases {
+
+enum class Base : uint8_t { Decimal = 10, Hex = 16, Octal = 8 };
+
+// Most characters format() writes for an Int in base
+template <typename Int>
+constexpr size_t maxChars(Base base) {
+    static_assert(std::is_integral_v<Int> && !std::is_same_v<Int, bool>);
+    constexpr size_t bits = sizeof(Int) * 8;
+    switch (base) {
+        case Base::Decimal:
+            return std::numeric_limits<Int>::digits10 + 1 + std::is_signed_v<Int>;
+        case Base::Hex:
+            return bits / 4;
+        case Base::Octal:
+            return (bits + 2) / 3;
+    }
+    return 0;
+}
+
+// Writes value in base and returns the end; out needs maxChars<Int>(base) bytes
+template <typename Int>
+char* format(char* out, Int value, Base base) {
+    char* end = out + maxChars<Int>(base);
+    if (base == Base::Decimal) {
+        return std::to_chars(out, end, value).ptr;
+    }
+    return std::to_chars(out, end, static_cast<std::make_unsigned_t<Int>>(value),
+                         static_cast<int>(base))
+        .ptr;
+}
+
+// Bytes formatAll() needs for count values
+template <typename Int>
+constexpr size_t formatAllBytes(size_t count, Base base) {
+    return count * (maxChars<Int>(base) + 1);
+}
+
+#ifdef CPP_QUEST_HAS_SSE2_HEX
+// The 16 hex digits of v, most significant first, as ASCII
+inline __m128i hexDigits(uint64_t v) {
+    __m128i bytes = _mm_cvtsi64_si128(static_cast<long long>(__builtin_bswap64(v)));
+    __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+    __m128i low = _mm_and_si128(bytes, mask);
+    __m128i nibbles = _mm_unpacklo_epi8(high, low);
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                                    _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(nibbles, _mm_add_epi8(letters, _mm_set1_epi8('0')));
+}
+
+// Writes v's significant hex digits. Stores sizeof(Int) * 2 bytes whatever the length, which
+// the room formatAll() keeps for each value always covers.
+template <typename Int>
+char* formatHex(char* out, Int value) {
+    constexpr int bits = sizeof(Int) * 8;
+    uint64_t v = static_cast<std::make_unsigned_t<Int>>(value);
+    int digits = v ? (64 - __builtin_clzll(v) + 3) / 4 : 1;
+    // Significant digits first: the shift drops the leading zeros (and, for 32 bits, the
+    // empty upper half)
+    __m128i ascii = hexDigits(v << (64 - digits * 4));
+    if constexpr (bits == 64) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), ascii);
+    } else {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), ascii);
+    }
+    return out + digits;
+}
+#endif
+
+// Writes every value in base, each followed by separator, and returns the end; out needs
+// formatAllBytes<Int>(count, base) bytes
+template <typename Int>
+char* formatAll(char* out, const Int* values, size_t count, Base base, char separator = '\n') {
+#ifdef CPP_QUEST_HAS_SSE2_HEX
+    if constexpr (sizeof(Int) == 4 || sizeof(Int) == 8) {
+        if (base == Base::Hex) {
+            for (size_t i = 0; i < count; ++i) {
+                out = formatHex(out, values[i]);
+                *out++ = separator;
+            }
+            return out;
+        }
+    }
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        out = format(out, values[i], base);
+        *out++ = separator;
+    }
+    return out;
+}
+
+}  // namespace bases
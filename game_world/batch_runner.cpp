@@ -0,0 +1,153 @@
+#include "batch_runner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <thread>
+
+#include "game_engine.h"
+#include "private_dir.h"
+
+namespace {
+
+// Read-only streambuf over a script that is already in memory (no copy per session)
+class ScriptBuf : public std::streambuf {
+   public:
+    explicit ScriptBuf(const std::string& script) {
+        char* begin = const_cast<char*>(script.data());
+        setg(begin, begin, begin + script.size());
+    }
+};
+
+struct WorkerTally {
+    size_t victories = 0;
+    size_t deaths = 0;
+    size_t quits = 0;
+    size_t outOfInput = 0;
+};
+
+void tally(WorkerTally& counts, GameOutcome outcome) {
+    switch (outcome) {
+        case GameOutcome::Victory:
+            ++counts.victories;
+            break;
+        case GameOutcome::Death:
+            ++counts.deaths;
+            break;
+        case GameOutcome::Quit:
+            ++counts.quits;
+            break;
+        case GameOutcome::InProgress:
+        case GameOutcome::OutOfInput:
+            ++counts.outOfInput;
+            break;
+    }
+}
+
+}  // namespace
+
+BatchReport runBatch(const BatchOptions& options) {
+    BatchReport report;
+    report.sessions = options.scripts.empty() ? 0 : options.sessions;
+
+    // This run's own save files, removed when it ends
+    PrivateDir saveDir;
+    if (report.sessions > 0 && !saveDir.create("cpp_quest_batch_", report.error)) {
+        report.sessions = 0;
+        return report;
+    }
+
+    unsigned threads = options.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads =
+        static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, report.sessions)));
+    report.threads = threads;
+
+    if (options.captureOutput) {
+        report.transcripts.resize(report.sessions);
+    }
+
+    std::vector<WorkerTally> tallies(threads);
+    std::atomic<size_t> nextSession{0};
+
+    auto worker = [&](unsigned id) {
+        // Sessions on one worker run back to back, so they can share a save file
+        std::string savePath = (saveDir.path() / ("worker_" + std::to_string(id))).string();
+        NullSink discard;
+
+        for (size_t i = nextSession.fetch_add(1); i < report.sessions;
+             i = nextSession.fetch_add(1)) {
+            ScriptBuf script(options.scripts[i % options.scripts.size()]);
+            std::istream in(&script);
+            MemorySink captured;
+            OutputSink& out = options.captureOutput ? static_cast<OutputSink&>(captured) : discard;
+
+            GameEngine game(in, out);
+            game.setSavePath(savePath);
+            game.seedRandom(GameRng::forStream(options.seed, i));
+            if (options.dungeon) {
+                game.loadDungeon(*options.dungeon);
+            }
+            game.initialize();
+            game.run();
+
+            tally(tallies[id], game.getOutcome());
+            if (options.captureOutput) {
+                report.transcripts[i] = captured.take();
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned id = 1; id < threads; ++id) {
+        pool.emplace_back(worker, id);
+    }
+    worker(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+    report.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& t : tallies) {
+        report.victories += t.victories;
+        report.deaths += t.deaths;
+        report.quits += t.quits;
+        report.outOfInput += t.outOfInput;
+    }
+
+    return report;
+}
+
+void printBatchReport(std::ostream& out, const BatchReport& report) {
+    out << "Batch simulation\n";
+    out << "  Sessions:     " << report.sessions << " on " << report.threads << " thread(s)\n";
+    out << "  Elapsed:      " << report.seconds << " s\n";
+    out << "  Throughput:   " << static_cast<long long>(report.sessionsPerSecond())
+        << " sessions/s\n";
+    out << "  Victories:    " << report.victories << "\n";
+    out << "  Deaths:       " << report.deaths << "\n";
+    out << "  Quits:        " << report.quits << "\n";
+    out << "  Out of input: " << report.outOfInput << "\n";
+}
+
+bool loadBatchScripts(const std::string& path, std::vector<std::string>& scripts) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find_first_not_of(" \t\r") != std::string::npos) {
+            scripts.push_back(line);
+        }
+    }
+    return true;
+}
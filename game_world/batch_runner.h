@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct GeneratedDungeon;
+
+/**
+ * Headless batch simulation
+ *
+ * Feeds in-memory command scripts to many GameEngine instances and runs them
+ * in parallel. Used for balance regression runs, where one process per
+ * session is far too slow.
+ */
+
+struct BatchOptions {
+    // Command scripts (whitespace-separated commands); session i plays scripts[i % size]
+    std::vector<std::string> scripts;
+    size_t sessions = 1;
+    // 0 means one worker per hardware thread
+    unsigned threads = 0;
+    // Keep each session's full output; otherwise it is discarded
+    bool captureOutput = false;
+    // Session i plays with GameRng::forStream(seed, i), whatever thread runs it
+    uint64_t seed = 1;
+    // Generated dungeon every session starts in (copied per session); null for the built-in one
+    const GeneratedDungeon* dungeon = nullptr;
+};
+
+struct BatchReport {
+    size_t sessions = 0;
+    unsigned threads = 0;
+    double seconds = 0.0;
+
+    size_t victories = 0;
+    size_t deaths = 0;
+    size_t quits = 0;
+    size_t outOfInput = 0;
+
+    // One entry per session when BatchOptions::captureOutput is set
+    std::vector<std::string> transcripts;
+
+    // Set (and nothing run) if the run's save directory could not be made
+    std::string error;
+
+    double sessionsPerSecond() const { return seconds > 0.0 ? sessions / seconds : 0.0; }
+};
+
+BatchReport runBatch(const BatchOptions& options);
+
+void printBatchReport(std::ostream& out, const BatchReport& report);
+
+// Reads one script per non-empty line; returns false if the file cannot be opened
+bool loadBatchScripts(const std::string& path, std::vector<std::string>& scripts);
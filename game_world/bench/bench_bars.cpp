@@ -0,0 +1,64 @@
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "bar_renderer.h"
+#include "bench_harness.h"
+
+/*
+ * Health bars 20 cells wide, at every fill level: written glyph by glyph to
+ * an std::ostream (as showStats and displayBar used to), rendered one at a
+ * time into a buffer, and rendered as a batch of 1000 (--bars=<n>) in one
+ * call. The stream discards what it is given, so only formatting is timed.
+ */
+
+namespace {
+
+constexpr int WIDTH = 20;
+
+class DiscardBuf : public std::streambuf {
+   protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+void streamBar(std::ostream& out, int current, int max, int width) {
+    int filled = max > 0 ? (current * width) / max : 0;
+    out << "[";
+    for (int i = 0; i < width; ++i) {
+        out << (i < filled ? "█" : "░");
+    }
+    out << "]";
+}
+
+}  // namespace
+
+BENCH_CASE(health_bars) {
+    const size_t count = run.option("bars", 1000);
+    std::vector<bars::Bar> party(count);
+    for (size_t i = 0; i < count; ++i) {
+        party[i] = {static_cast<int>(i % 101), 100};
+    }
+
+    DiscardBuf discard;
+    std::ostream stream(&discard);
+    run.measure("iostream/per-glyph", count, [&] {
+        for (const bars::Bar& bar : party) {
+            streamBar(stream, bar.current, bar.max, WIDTH);
+        }
+    });
+
+    char one[bars::barBytes(WIDTH)];
+    run.measure("renderBar", count, [&] {
+        for (const bars::Bar& bar : party) {
+            bench::doNotOptimize(bars::renderBar(one, bar.current, bar.max, WIDTH));
+        }
+    });
+
+    std::string batch(bars::batchBytes(count, WIDTH), '\0');
+    run.measure("renderBars/batch", count, [&] {
+        bench::doNotOptimize(bars::renderBars(&batch[0], party.data(), count, WIDTH));
+    });
+    run.note(std::to_string(batch.size()) + " B for " + std::to_string(count) + " bars");
+}
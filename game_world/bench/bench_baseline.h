@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+
+/**
+ * Stored timings for perf regression checks
+ *
+ * A baseline file has one line per variant: case, variant, best ns/item and
+ * optionally a tolerance in percent; `#` starts a comment. checkBaselines()
+ * compares a run's best ns/item (the least noisy figure) with the file and
+ * fails any variant slower than its baseline by more than the tolerance.
+ * update() rewrites the lines for the variants just measured, keeping
+ * everything else (comments, other cases, hand-set tolerances).
+ *
+ * Timings only mean something on the machine that recorded them: record the
+ * file where the checks run.
+ */
+
+namespace bench {
+
+struct Baseline {
+    std::string caseName;
+    std::string label;
+    double bestNsPerItem = 0.0;
+    double tolerancePercent = -1.0;  // below 0: the run's default
+};
+
+class BaselineFile {
+   public:
+    // False if the file can't be read; a malformed line is an error too
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "Could not open baseline file: " + path;
+            return false;
+        }
+        std::string line;
+        for (size_t number = 1; std::getline(file, line); ++number) {
+            lines_.push_back(line);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            Baseline baseline;
+            if (!(fields >> baseline.caseName >> baseline.label >> baseline.bestNsPerItem)) {
+                error = path + ":" + std::to_string(number) + ": expected case, variant, ns/item";
+                return false;
+            }
+            fields >> baseline.tolerancePercent;
+            entries_.push_back({baseline, lines_.size() - 1});
+        }
+        return true;
+    }
+
+    const Baseline* find(const Result& result) const {
+        for (const Entry& entry : entries_) {
+            if (entry.baseline.caseName == result.caseName &&
+                entry.baseline.label == result.label) {
+                return &entry.baseline;
+            }
+        }
+        return nullptr;
+    }
+
+    // Sets each result's baseline to its best ns/item, adding lines for new variants
+    void update(const std::vector<Result>& results) {
+        for (const Result& result : results) {
+            Entry* entry = findEntry(result);
+            if (!entry) {
+                lines_.emplace_back();
+                Baseline added{result.caseName, result.label, 0.0, -1.0};
+                entries_.push_back({added, lines_.size() - 1});
+                entry = &entries_.back();
+            }
+            entry->baseline.bestNsPerItem = result.bestNsPerItem;
+            lines_[entry->line] = format(entry->baseline);
+        }
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        for (const std::string& line : lines_) {
+            file << line << "\n";
+        }
+        return static_cast<bool>(file.flush());
+    }
+
+   private:
+    struct Entry {
+        Baseline baseline;
+        size_t line;
+    };
+
+    Entry* findEntry(const Result& result) {
+        for (Entry& entry : entries_) {
+            if (entry.baseline.caseName == result.caseName &&
+                entry.baseline.label == result.label) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    static std::string format(const Baseline& baseline) {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%.2f", baseline.bestNsPerItem);
+        std::string line = baseline.caseName + " " + baseline.label + " " + number;
+        if (baseline.tolerancePercent >= 0) {
+            std::snprintf(number, sizeof(number), "%g", baseline.tolerancePercent);
+            line += std::string(" ") + number;
+        }
+        return line;
+    }
+
+    std::vector<std::string> lines_;
+    std::vector<Entry> entries_;
+};
+
+/**
+ * Prints each result against its baseline and returns the number that regressed. A run
+ * in which nothing had a baseline counts as a failure, so a renamed case or variant
+ * can't pass silently.
+ */
+inline size_t checkBaselines(const std::vector<Result>& results, const BaselineFile& baselines,
+                             double defaultTolerancePercent) {
+    std::printf("%-24s %-32s %12s %12s %9s %9s\n", "case", "variant", "baseline", "best",
+                "change", "allowed");
+    size_t checked = 0;
+    size_t failures = 0;
+    for (const Result& result : results) {
+        const Baseline* baseline = baselines.find(result);
+        if (!baseline) {
+            std::printf("%-24s %-32s %12s %12.2f  (no baseline)\n", result.caseName.c_str(),
+                        result.label.c_str(), "-", result.bestNsPerItem);
+            continue;
+        }
+        ++checked;
+        double tolerance = baseline->tolerancePercent >= 0 ? baseline->tolerancePercent
+                                                           : defaultTolerancePercent;
+        double change = (result.bestNsPerItem / baseline->bestNsPerItem - 1.0) * 100.0;
+        bool slower = change > tolerance;
+        failures += slower;
+        std::printf("%-24s %-32s %12.2f %12.2f %+8.1f%% %+8.1f%%  %s\n",
+                    result.caseName.c_str(), result.label.c_str(), baseline->bestNsPerItem,
+                    result.bestNsPerItem, change, tolerance, slower ? "SLOWER" : "ok");
+    }
+    if (checked == 0) {
+        std::printf("No result had a baseline\n");
+        return 1;
+    }
+    return failures;
+}
+
+}  // namespace bench
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstdint>
+#include <ios>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base_format.h"
+#include "bench_harness.h"
+
+/*
+ * 10^4 entity ids (--ids=<n>) of every magnitude, one per line, in each base:
+ * through an std::ostream switching std::hex/std::oct per value and back, with
+ * one std::to_chars call per value, and with bases::formatAll (the SSE2 path
+ * for hex). The stream discards what it is given, so only formatting is timed.
+ */
+
+namespace {
+
+class DiscardBuf : public std::streambuf {
+   protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+constexpr std::pair<bases::Base, const char*> BASES[] = {
+    {bases::Base::Decimal, "dec"}, {bases::Base::Hex, "hex"}, {bases::Base::Octal, "oct"}};
+
+std::ios_base& (*manipulator(bases::Base base))(std::ios_base&) {
+    switch (base) {
+        case bases::Base::Hex:
+            return std::hex;
+        case bases::Base::Octal:
+            return std::oct;
+        default:
+            return std::dec;
+    }
+}
+
+}  // namespace
+
+BENCH_CASE(number_format) {
+    const size_t count = run.option("ids", 10000);
+    std::mt19937 rng(7);
+    std::vector<uint32_t> ids(count);
+    for (uint32_t& id : ids) {
+        id = rng() >> (rng() % 32);
+    }
+
+    DiscardBuf discard;
+    std::ostream stream(&discard);
+    size_t bytes = 0;
+    for (auto [base, name] : BASES) {
+        bytes = std::max(bytes, bases::formatAllBytes<uint32_t>(count, base));
+    }
+    std::string buffer(bytes, '\0');
+    for (auto [base, name] : BASES) {
+        run.measure(std::string("iostream/") + name, count, [&, base = base] {
+            for (uint32_t id : ids) {
+                stream << manipulator(base) << id << std::dec << '\n';
+            }
+        });
+
+        run.measure(std::string("to_chars/") + name, count, [&, base = base] {
+            char* out = &buffer[0];
+            for (uint32_t id : ids) {
+                out = bases::format(out, id, base);
+                *out++ = '\n';
+            }
+            bench::doNotOptimize(out);
+        });
+
+        run.measure(std::string("formatAll/") + name, count, [&, base = base] {
+            bench::doNotOptimize(bases::formatAll(&buffer[0], ids.data(), count, base));
+        });
+    }
+}
@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "dungeon_generator.h"
+#include "world_store.h"
+
+/*
+ * A long walk through a generated world of 10^6 rooms (--rooms=<n>), kept in
+ * memory and streamed from a chunk file with caches of a few sizes
+ * (--resident=<chunks> for the small one). Each step does what move() and
+ * describeLocation() read and write: name, description, enemies, treasure,
+ * the visited flag and the exits.
+ */
+
+namespace {
+
+using RoomId = WorldStore::RoomId;
+
+// Walks `steps` rooms, preferring exits not taken straight back
+size_t walk(WorldStore& world, size_t steps, bool prefetch) {
+    std::mt19937 rng(17);
+    RoomId room = 0;
+    RoomId previous = WorldStore::NO_ROOM;
+    size_t seen = 0;
+    for (size_t s = 0; s < steps; ++s) {
+        seen += world.name(room).size() + world.description(room).size();
+        seen += world.enemyCount(room) + world.treasureCount(room);
+        world.markVisited(room);
+
+        auto exits = world.exits(room);
+        RoomId next = WorldStore::NO_ROOM;
+        for (int tries = 0; tries < 8 && (next == WorldStore::NO_ROOM || next == previous);
+             ++tries) {
+            next = exits[rng() % WorldStore::EXIT_SLOTS];
+        }
+        previous = room;
+        room = next != WorldStore::NO_ROOM ? next : previous;
+        if (prefetch) {
+            world.prefetchExits(room);
+        }
+    }
+    return seen;
+}
+
+std::string describe(const ChunkCacheStats& stats) {
+    char text[160];
+    std::snprintf(text, sizeof(text), "%.2f%% hits, %zu KiB resident, %llu evicted, %llu written",
+                  stats.hitRate() * 100.0, stats.residentBytes / 1024,
+                  static_cast<unsigned long long>(stats.evictions),
+                  static_cast<unsigned long long>(stats.writebacks));
+    return text;
+}
+
+}  // namespace
+
+BENCH_CASE(world_chunks) {
+    GeneratorOptions options;
+    options.rooms = run.option("rooms", 1000000);
+    GeneratedDungeon dungeon = generateDungeon(options);
+    const size_t steps = 200000;
+    const std::string path = "bench_world_chunks.tmp";
+
+    WorldStore memory = dungeon.world.cloneInMemory();
+    run.measure("walk/in-memory", steps, [&] { bench::doNotOptimize(walk(memory, steps, false)); });
+    run.note(std::to_string(memory.memoryBytes() >> 10) + " KiB");
+
+    size_t small = run.option("resident", 8);
+    for (size_t resident : {small, small * 32}) {
+        for (bool prefetch : {false, true}) {
+            WorldStore streamed = dungeon.world.cloneInMemory();
+            streamed.streamTo(path, resident);
+            std::string label = "walk/" + std::to_string(resident) + "-chunks" +
+                                (prefetch ? "-prefetch" : "");
+            run.measure(label, steps,
+                        [&] { bench::doNotOptimize(walk(streamed, steps, prefetch)); });
+            run.note(describe(streamed.chunkStats()));
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#include "bench_harness.h"
+#include "combat_sim.h"
+
+/*
+ * Combat simulation: the Ancient Dragon fight (the longest one) with the
+ * scalar loop and with eight AVX2 lanes. Both paths must give the same wins
+ * and health left; the note says whether they did.
+ */
+
+BENCH_CASE(combat_sim) {
+    const CombatRules rules = engineCombatRules();
+    const CombatSetup dragon{100, 15 + 10, 150, rules.enemyUsesAttack ? 25 : rules.fixedEnemyBase};
+    CombatSimOptions options;
+    options.fights = run.option("fights", 200000);
+
+    CombatStats scalar;
+    options.forceScalar = true;
+    run.measure("dragon/scalar", options.fights,
+                [&] { scalar = simulateCombat(rules, dragon, options); });
+
+    if (!combatSimHasAvx2()) {
+        return;
+    }
+    CombatStats vector;
+    options.forceScalar = false;
+    run.measure("dragon/avx2", options.fights,
+                [&] { vector = simulateCombat(rules, dragon, options); });
+    bool same = scalar.wins == vector.wins && scalar.rounds == vector.rounds &&
+                scalar.hpLeft == vector.hpLeft;
+    run.note(same ? "matches scalar" : "MISMATCH with scalar");
+}
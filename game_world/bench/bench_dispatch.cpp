@@ -0,0 +1,99 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_harness.h"
+#include "command_table.h"
+
+/*
+ * Command dispatch: the perfect-hash command table against the if/else chain
+ * of string compares that run() used before. Both resolve the same mix of
+ * words (common commands, aliases and unknown words) to an opcode.
+ */
+
+namespace {
+
+// The chain from the old run(), returning the opcode it would have dispatched
+Command legacyResolve(const std::string& command) {
+    if (command == "n" || command == "north")
+        return Command::North;
+    else if (command == "s" || command == "south")
+        return Command::South;
+    else if (command == "e" || command == "east")
+        return Command::East;
+    else if (command == "w" || command == "west")
+        return Command::West;
+    else if (command == "look")
+        return Command::Look;
+    else if (command == "fight")
+        return Command::Fight;
+    else if (command == "flee")
+        return Command::Flee;
+    else if (command == "loot")
+        return Command::Loot;
+    else if (command == "stats")
+        return Command::Stats;
+    else if (command == "inv")
+        return Command::Inventory;
+    else if (command == "quests")
+        return Command::Quests;
+    else if (command == "save")
+        return Command::Save;
+    else if (command == "load")
+        return Command::Load;
+    else if (command == "quit")
+        return Command::Quit;
+    return Command::Unknown;
+}
+
+const std::vector<std::string>& sampleWords() {
+    static const std::vector<std::string> words = {
+        "n", "fight", "loot", "e", "look", "w", "north", "stats", "inv", "flee",
+        "s", "quests", "save", "load", "dance", "quit", "south", "west", "east", "xyzzy",
+    };
+    return words;
+}
+
+}  // namespace
+
+BENCH_CASE(command_dispatch) {
+    const auto& words = sampleWords();
+    std::vector<std::string_view> views(words.begin(), words.end());
+    const size_t rounds = 50000;
+    const size_t items = rounds * words.size();
+
+    run.measure("resolve/if-else-chain", items, [&] {
+        unsigned sum = 0;
+        for (size_t r = 0; r < rounds; ++r) {
+            for (const auto& w : words) {
+                sum += static_cast<unsigned>(legacyResolve(w));
+            }
+        }
+        bench::doNotOptimize(sum);
+    });
+    run.measure("resolve/perfect-hash", items, [&] {
+        unsigned sum = 0;
+        for (size_t r = 0; r < rounds; ++r) {
+            for (auto w : views) {
+                sum += static_cast<unsigned>(resolveCommand(w));
+            }
+        }
+        bench::doNotOptimize(sum);
+    });
+
+    // Full parse of a scripted line: tokenizing, lookup and argument handling
+    std::string line = "n fight loot 2 go east look w loot stats inv go north flee quit";
+    size_t perLine = 13;
+    run.measure("parse/script-line", rounds * perLine, [&] {
+        unsigned sum = 0;
+        CommandParser parser;
+        ParsedCommand command;
+        for (size_t r = 0; r < rounds; ++r) {
+            parser.reset(line);
+            while (parser.next(command)) {
+                sum += static_cast<unsigned>(command.command) + command.argument.size();
+            }
+        }
+        bench::doNotOptimize(sum);
+    });
+}
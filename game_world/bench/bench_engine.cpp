@@ -0,0 +1,245 @@
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include "bench_harness.h"
+#include "game_engine.h"
+
+#ifdef SESSION_01_AVAILABLE
+#    include "01_compilers_forge/starter/display.h"
+#endif
+
+/*
+ * Engine hot paths, each timed on its own: building the dungeon, describing a
+ * room, moving, a whole fight, looting, and saving/loading a snapshot. Output
+ * goes to a NullSink, so the figures are the engine's own cost.
+ */
+
+struct EngineBenchAccess {
+    static void createDungeon(GameEngine& game) { game.createDungeon(); }
+
+    static void describeLocation(GameEngine& game) {
+        game.describeLocation();
+        game.out_.flush();
+    }
+
+    static void move(GameEngine& game, char direction) {
+        game.move(direction);
+        game.out_.flush();
+    }
+
+    static void fight(GameEngine& game) {
+        game.fight();
+        game.out_.flush();
+    }
+
+    static void loot(GameEngine& game) {
+        game.loot();
+        game.out_.flush();
+    }
+
+    static void saveGame(GameEngine& game) {
+        game.saveGame();
+        game.out_.flush();
+    }
+
+    static void loadGame(GameEngine& game) {
+        game.loadGame();
+        game.out_.flush();
+    }
+
+    static void setLocation(GameEngine& game, int room) { game.currentLocation_ = room; }
+
+    // Full health and an empty bag, so repeated fights and loots start from the same state
+    static void resetPlayer(GameEngine& game) {
+        game.playerHealth_ = game.playerMaxHealth_;
+        game.playerGold_ = 0;
+        game.items_.clear();
+#ifdef SESSION_02_AVAILABLE
+        game.inventory_.reset();
+#endif
+    }
+
+    static void defeatEnemies(GameEngine& game) {
+        for (EnemyStore::EnemyId id = 0; id < game.enemies_.size(); ++id) {
+            game.enemies_.setHealth(id, 0);
+        }
+    }
+};
+
+namespace {
+
+constexpr int ENTRANCE = 0;
+constexpr int GRAND_HALL = 1;
+
+// Discards what is written to std::cout while Session 1 display functions run
+class DiscardBuf : public std::streambuf {
+   protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+class QuietGame {
+   public:
+    QuietGame() : game(in, sink) { game.seedRandom(1); }
+
+    std::istringstream in;
+    NullSink sink;
+    GameEngine game;
+};
+
+}  // namespace
+
+BENCH_CASE(engine) {
+    QuietGame quiet;
+    GameEngine& game = quiet.game;
+    const size_t reps = 2000;
+
+    run.measure("createDungeon", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            EngineBenchAccess::createDungeon(game);
+        }
+    });
+    const builtin::Dungeon& shared = builtin::dungeon();
+    run.note(std::to_string(shared.world.stateBytes()) + " B of world per game, " +
+             std::to_string(shared.world.layoutBytes()) + " B shared");
+
+    // The Grand Hall has an enemy, treasure and four exits
+    EngineBenchAccess::createDungeon(game);
+    EngineBenchAccess::setLocation(game, GRAND_HALL);
+    run.measure("describeLocation", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            EngineBenchAccess::describeLocation(game);
+        }
+    });
+
+    EngineBenchAccess::defeatEnemies(game);
+    EngineBenchAccess::setLocation(game, ENTRANCE);
+    run.measure("move", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            EngineBenchAccess::move(game, (i & 1) ? 's' : 'n');
+        }
+    });
+
+    // Each fight needs a fresh goblin, so this includes createDungeon (timed above)
+    run.measure("fight+createDungeon", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            EngineBenchAccess::createDungeon(game);
+            EngineBenchAccess::resetPlayer(game);
+            EngineBenchAccess::setLocation(game, GRAND_HALL);
+            EngineBenchAccess::fight(game);
+        }
+    });
+
+    // Likewise, treasure has to be put back before each loot
+    run.measure("loot+createDungeon", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            EngineBenchAccess::createDungeon(game);
+            EngineBenchAccess::resetPlayer(game);
+            EngineBenchAccess::setLocation(game, GRAND_HALL);
+            EngineBenchAccess::loot(game);
+        }
+    });
+}
+
+BENCH_CASE(engine_save_load) {
+    QuietGame quiet;
+    GameEngine& game = quiet.game;
+    std::string path =
+        (std::filesystem::temp_directory_path() / "cpp_quest_bench_save").string();
+    game.setSavePath(path);
+
+    size_t rooms = run.option("rooms", 0);
+    GeneratedDungeon dungeon;
+    if (rooms > 0) {
+        GeneratorOptions options;
+        options.rooms = rooms;
+        dungeon = generateDungeon(options);
+        game.loadDungeon(dungeon);
+    }
+    std::string label = rooms > 0 ? "/" + std::to_string(rooms) + "-rooms" : "/built-in";
+
+    run.measure("saveGame" + label, 1, [&] { EngineBenchAccess::saveGame(game); });
+    run.measure("loadGame" + label, 1, [&] { EngineBenchAccess::loadGame(game); });
+
+    std::error_code ignored;
+    std::filesystem::remove(path + ".bin", ignored);
+}
+
+// Crash recovery: rebuilding a game from its base snapshot and a journal of commands
+BENCH_CASE(journal_replay) {
+    std::string path =
+        (std::filesystem::temp_directory_path() / "cpp_quest_bench_journal").string();
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+
+    // Clear the Grand Hall, then walk in and out of it (three journaled commands a lap)
+    const size_t laps = 1300;
+    {
+        QuietGame quiet;
+        std::string error;
+        quiet.game.initialize();
+        quiet.game.openJournal(path, error);
+        quiet.game.handleLine("n fight");
+        for (size_t i = 0; i < laps; ++i) {
+            quiet.game.handleLine("s n look");
+        }
+    }
+
+    run.measure("recover/" + std::to_string(2 + 3 * laps) + "-commands", 2 + 3 * laps, [&] {
+        QuietGame quiet;
+        std::string error;
+        quiet.game.initialize();
+        quiet.game.openJournal(path, error);
+    });
+
+    std::filesystem::remove(path, ignored);
+}
+
+#ifdef SESSION_01_AVAILABLE
+BENCH_CASE(session01_display) {
+    DiscardBuf discard;
+    std::streambuf* saved = std::cout.rdbuf(&discard);
+    const size_t reps = 10000;
+
+    run.measure("displayBar", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            displayBar(static_cast<int>(i % 101), 100, 20);
+        }
+    });
+    run.measure("displayCharacter", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            displayCharacter("Aria", "Mage", 5, static_cast<int>(i % 101), 100);
+        }
+    });
+    run.measure("displayInBases", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            displayInBases(static_cast<int>(i * 2654435761u));
+        }
+    });
+    run.measure("displayTypeInfo", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            displayTypeInfo<double>("double");
+        }
+    });
+
+    std::cout.rdbuf(saved);
+}
+#endif
+
+// What every batch or hosted session pays before its first command
+BENCH_CASE(engine_startup) {
+    const size_t reps = 2000;
+    run.measure("construct+initialize", reps, [&] {
+        for (size_t i = 0; i < reps; ++i) {
+            std::istringstream in;
+            NullSink sink;
+            GameEngine game(in, sink);
+            game.seedRandom(i);
+            game.initialize();
+            bench::doNotOptimize(game.isRunning());
+        }
+    });
+}
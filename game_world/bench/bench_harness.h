@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Minimal self-contained benchmark harness for game_bench
+ *
+ * A benchmark case is a function registered with BENCH_CASE. It sets up its
+ * data and calls run.measure() for each variant it wants timed; measure()
+ * repeats the body until enough time has passed and records the cost per
+ * item processed.
+ */
+
+namespace bench {
+
+// Keeps the compiler from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Result {
+    std::string caseName;
+    std::string label;
+    size_t itemsPerRep;
+    size_t reps;
+    double nsPerItem;     // mean over all repetitions
+    double bestNsPerItem;  // fastest single repetition
+    std::string note;      // extra figures a case reports alongside the timing
+};
+
+class Run {
+   public:
+    Run(std::string caseName, const std::vector<std::string>& args, double minSeconds)
+        : caseName_(std::move(caseName)), args_(args), minSeconds_(minSeconds) {}
+
+    // Reads --name=value from the command line, or returns fallback
+    size_t option(const std::string& name, size_t fallback) const {
+        std::string prefix = "--" + name + "=";
+        for (const auto& arg : args_) {
+            if (arg.rfind(prefix, 0) == 0) {
+                return std::stoull(arg.substr(prefix.size()));
+            }
+        }
+        return fallback;
+    }
+
+    // Times fn(), which processes `items` units of work per call
+    template <typename Fn>
+    void measure(const std::string& label, size_t items, Fn&& fn) {
+        using Clock = std::chrono::steady_clock;
+        fn();  // warm-up
+
+        size_t reps = 0;
+        double total = 0.0;
+        double best = 0.0;
+        while (reps < 3 || total < minSeconds_) {
+            auto start = Clock::now();
+            fn();
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            total += elapsed;
+            best = reps == 0 ? elapsed : std::min(best, elapsed);
+            ++reps;
+        }
+
+        double perItem = 1e9 / static_cast<double>(items == 0 ? 1 : items);
+        results_.push_back(
+            {caseName_, label, items, reps, total / reps * perItem, best * perItem, ""});
+    }
+
+    // Attaches a note (for example "1.0 writes/turn") to the last measurement
+    void note(const std::string& text) {
+        if (!results_.empty()) {
+            results_.back().note = text;
+        }
+    }
+
+    const std::vector<Result>& results() const { return results_; }
+
+   private:
+    std::string caseName_;
+    const std::vector<std::string>& args_;
+    double minSeconds_;
+    std::vector<Result> results_;
+};
+
+using CaseFn = void (*)(Run&);
+
+struct Case {
+    const char* name;
+    CaseFn fn;
+};
+
+inline std::vector<Case>& registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+struct Register {
+    Register(const char* name, CaseFn fn) { registry().push_back({name, fn}); }
+};
+
+}  // namespace bench
+
+#define BENCH_CASE(name)                                        \
+    static void name(bench::Run& run);                          \
+    static const bench::Register name##_registration(#name, name); \
+    static void name(bench::Run& run)
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_harness.h"
+#include "inventory_store.h"
+#include "snapshot.h"
+
+/*
+ * A bulk bot's bag of 10^5 items, held the way the engine used to (a vector
+ * of name/value pairs) and in an InventoryStore: filling it, the totals the
+ * status line needs, walking it by value and by rarity, and a snapshot round
+ * trip.
+ */
+
+namespace {
+
+using LegacyBag = std::vector<std::pair<std::string, int>>;
+
+long long legacyGold(const LegacyBag& bag) {
+    long long gold = 0;
+    for (const auto& item : bag) {
+        gold += item.second;
+    }
+    return gold;
+}
+
+}  // namespace
+
+BENCH_CASE(inventory) {
+    size_t count = run.option("items", 100000);
+    std::vector<ItemId> pickups(count);
+    std::mt19937 rng(11);
+    for (auto& item : pickups) {
+        item = static_cast<ItemId>(rng() % ITEM_COUNT);
+    }
+
+    LegacyBag legacy;
+    InventoryStore store;
+
+    run.measure("fill/legacy", count, [&] {
+        legacy.clear();
+        for (ItemId item : pickups) {
+            legacy.emplace_back(std::string(itemDefinition(item).name), itemDefinition(item).value);
+        }
+    });
+    run.measure("fill/store", count, [&] {
+        store.clear();
+        for (ItemId item : pickups) {
+            store.add(item);
+        }
+    });
+
+    // One status line's worth of totals per pickup, as a bot checks its bag each turn
+    run.measure("totals/legacy", 1, [&] { bench::doNotOptimize(legacyGold(legacy)); });
+    run.measure("totals/store", 1, [&] {
+        bench::doNotOptimize(store.gold());
+        bench::doNotOptimize(store.weight());
+    });
+
+    // The most valuable tenth of the bag
+    run.measure("top-value/legacy", count, [&] {
+        std::vector<const std::pair<std::string, int>*> sorted;
+        sorted.reserve(legacy.size());
+        for (const auto& item : legacy) {
+            sorted.push_back(&item);
+        }
+        std::partial_sort(sorted.begin(), sorted.begin() + count / 10, sorted.end(),
+                          [](const auto* a, const auto* b) { return a->second > b->second; });
+        bench::doNotOptimize(sorted[0]);
+    });
+    run.measure("top-value/store", count, [&] {
+        size_t left = count / 10;
+        long long gold = 0;
+        store.forEachByValue([&](InventoryStore::Handle, ItemId item) {
+            if (left > 0) {
+                --left;
+                gold += itemDefinition(item).value;
+            }
+        });
+        bench::doNotOptimize(gold);
+    });
+
+    run.measure("rarity/store", count, [&] {
+        size_t rare = 0;
+        store.forEachOfRarity(quest::Rarity::Rare, [&](InventoryStore::Handle, ItemId) { ++rare; });
+        bench::doNotOptimize(rare);
+    });
+
+    run.measure("iterate/store", count, [&] {
+        long long weight = 0;
+        for (ItemId item : store) {
+            weight += itemDefinition(item).weight;
+        }
+        bench::doNotOptimize(weight);
+    });
+
+    run.measure("save/legacy", count, [&] {
+        SnapshotWriter out;
+        out.put<uint64_t>(legacy.size());
+        for (const auto& item : legacy) {
+            out.putString(item.first);
+            out.put<int32_t>(item.second);
+        }
+        bench::doNotOptimize(out.size());
+    });
+    run.measure("save/store", count, [&] {
+        SnapshotWriter out;
+        store.writeSnapshot(out);
+        bench::doNotOptimize(out.size());
+    });
+
+    SnapshotWriter saved;
+    store.writeSnapshot(saved);
+    InventoryStore loaded;
+    run.measure("load/store", count, [&] {
+        SnapshotReader in(saved.data(), saved.size());
+        loaded.readSnapshot(in);
+    });
+    run.note(std::to_string(store.memoryBytes() / 1024) + " KiB in the pool");
+}
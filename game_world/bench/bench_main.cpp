@@ -0,0 +1,155 @@
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bench_baseline.h"
+#include "bench_harness.h"
+
+/*
+ * game_bench [filter] [--min-time=<ms>] [--json] [--<option>=<value>...]
+ *            [--check=<baselines> [--tolerance=<percent>]] [--write-baseline=<baselines>]
+ *
+ * Runs every registered case whose name contains `filter`. Cases read their
+ * own size options (for example --rooms=1000000). --json prints the results
+ * as one JSON document instead of a table, for comparing runs over time.
+ *
+ * --check compares the results with a baseline file (see bench_baseline.h)
+ * and exits with 1 if any variant is slower than its baseline by more than its
+ * tolerance (default 50%); the perf tests in ctest run this way.
+ * --write-baseline records the results in a baseline file instead.
+ */
+
+namespace {
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+void printJson(const std::vector<bench::Result>& results, const std::vector<std::string>& args,
+               double minSeconds) {
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::string commandLine;
+    for (const auto& arg : args) {
+        commandLine += (commandLine.empty() ? "" : " ") + arg;
+    }
+
+    std::printf("{\n");
+    std::printf("  \"suite\": \"game_bench\",\n");
+    std::printf("  \"format\": 1,\n");
+    std::printf("  \"timestamp\": \"%s\",\n", timestamp);
+#ifdef __VERSION__
+    std::printf("  \"compiler\": %s,\n", jsonString(__VERSION__).c_str());
+#endif
+    std::printf("  \"arguments\": %s,\n", jsonString(commandLine).c_str());
+    std::printf("  \"min_time_ms\": %.0f,\n", minSeconds * 1000.0);
+    std::printf("  \"results\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::printf("%s\n    {\"case\": %s, \"variant\": %s, \"items_per_rep\": %zu, "
+                    "\"reps\": %zu, \"ns_per_item\": %.3f, \"best_ns_per_item\": %.3f, "
+                    "\"note\": %s}",
+                    i == 0 ? "" : ",", jsonString(r.caseName).c_str(),
+                    jsonString(r.label).c_str(), r.itemsPerRep, r.reps, r.nsPerItem,
+                    r.bestNsPerItem, jsonString(r.note).c_str());
+    }
+    std::printf("\n  ]\n}\n");
+}
+
+// Value of --name=<value>, or empty
+std::string textOption(const std::vector<std::string>& args, const std::string& name) {
+    std::string prefix = "--" + name + "=";
+    for (const auto& arg : args) {
+        if (arg.rfind(prefix, 0) == 0) {
+            return arg.substr(prefix.size());
+        }
+    }
+    return "";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string filter;
+    bool json = false;
+    for (const auto& arg : args) {
+        if (arg == "--json") {
+            json = true;
+        } else if (arg.rfind("--", 0) != 0) {
+            filter = arg;
+        }
+    }
+
+    double minSeconds = 0.25;
+    double tolerance = 50.0;
+    {
+        bench::Run options("", args, 0.0);
+        minSeconds = static_cast<double>(options.option("min-time", 250)) / 1000.0;
+        tolerance = static_cast<double>(options.option("tolerance", 50));
+    }
+
+    std::string checkPath = textOption(args, "check");
+    std::string baselinePath = textOption(args, "write-baseline");
+    bench::BaselineFile baselines;
+    if (!checkPath.empty() || !baselinePath.empty()) {
+        const std::string& path = checkPath.empty() ? baselinePath : checkPath;
+        std::string error;
+        // A baseline file is created on its first write
+        if (!baselines.load(path, error) && (!checkPath.empty() || std::ifstream(path))) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+        json = false;
+    }
+    bool table = !json && checkPath.empty();
+
+    if (table) {
+        std::printf("%-24s %-32s %14s %14s %8s\n", "case", "variant", "ns/item", "best ns/item",
+                    "reps");
+    }
+    std::vector<bench::Result> all;
+    for (const auto& c : bench::registry()) {
+        if (!filter.empty() && std::string(c.name).find(filter) == std::string::npos) {
+            continue;
+        }
+        bench::Run run(c.name, args, minSeconds);
+        c.fn(run);
+        for (const auto& r : run.results()) {
+            if (table) {
+                std::printf("%-24s %-32s %14.2f %14.2f %8zu  %s\n", r.caseName.c_str(),
+                            r.label.c_str(), r.nsPerItem, r.bestNsPerItem, r.reps,
+                            r.note.c_str());
+            }
+            all.push_back(r);
+        }
+        std::fflush(stdout);
+    }
+
+    if (json) {
+        printJson(all, args, minSeconds);
+    }
+    if (!baselinePath.empty()) {
+        baselines.update(all);
+        if (!baselines.save(baselinePath)) {
+            std::fprintf(stderr, "Could not write baseline file: %s\n", baselinePath.c_str());
+            return 2;
+        }
+        std::printf("Recorded %zu baselines in %s\n", all.size(), baselinePath.c_str());
+    }
+    if (!checkPath.empty()) {
+        return bench::checkBaselines(all, baselines, tolerance) > 0 ? 1 : 0;
+    }
+    return 0;
+}
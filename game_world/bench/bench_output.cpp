@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "bench_harness.h"
+#include "game_engine.h"
+#include "output_frame.h"
+
+/*
+ * Turn output: a scripted session played through each output sink. Every turn
+ * is composed in the engine's frame and written once, so the fd sink should
+ * report one write(2) per turn.
+ */
+
+namespace {
+
+std::string turnScript(size_t rounds, size_t& turns) {
+    std::string script = "n fight loot";
+    turns = 3;
+    for (size_t i = 0; i < rounds; ++i) {
+        script += " e w w e stats inv look";
+        turns += 7;
+    }
+    script += " quit\n";
+    turns += 1;
+    return script;
+}
+
+void playSession(const std::string& script, OutputSink& sink) {
+    std::istringstream in(script);
+    GameEngine game(in, sink);
+    game.setSavePath("/dev/null");
+    game.initialize();
+    game.run();
+}
+
+}  // namespace
+
+BENCH_CASE(turn_output) {
+    size_t turns = 0;
+    const std::string script = turnScript(run.option("rounds", 100), turns);
+
+    run.measure("sink/null", turns, [&] {
+        NullSink sink;
+        playSession(script, sink);
+    });
+
+    run.measure("sink/memory", turns, [&] {
+        MemorySink sink;
+        playSession(script, sink);
+        bench::doNotOptimize(sink.text().size());
+    });
+
+    {
+        std::ostringstream stream;
+        run.measure("sink/stream(ostringstream)", turns, [&] {
+            stream.str("");
+            StreamSink sink(stream);
+            playSession(script, sink);
+        });
+    }
+
+    FileSink devNull("/dev/null");
+    size_t before = devNull.syscalls();
+    size_t sessions = 0;
+    run.measure("sink/fd(/dev/null)", turns, [&] {
+        playSession(script, devNull);
+        ++sessions;
+    });
+    if (devNull.isOpen() && sessions > 0) {
+        char note[64];
+        std::snprintf(note, sizeof(note), "%.2f writes/turn",
+                      static_cast<double>(devNull.syscalls() - before) /
+                          static_cast<double>(sessions * turns));
+        run.note(note);
+    }
+}
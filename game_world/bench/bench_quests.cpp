@@ -0,0 +1,88 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "quest_bus.h"
+
+/*
+ * A player with thousands of quests, each waiting on some enemy, item or
+ * room. The old way keeps quests in a vector and, for every event, scans it
+ * comparing names and copies the completed list to print one of them; the
+ * QuestBus hashes the event to the quests subscribed to it.
+ */
+
+namespace {
+
+struct LegacyQuest {
+    std::string id;
+    std::string subject;
+    bool completed;
+};
+
+// What the engine used to do per event: scan for matching quests, then copy the completed list
+size_t legacyPublish(std::vector<LegacyQuest>& quests, const std::string& subject) {
+    size_t done = 0;
+    for (auto& quest : quests) {
+        if (!quest.completed && quest.subject == subject) {
+            quest.completed = true;
+            std::vector<LegacyQuest> completed;
+            for (const auto& q : quests) {
+                if (q.completed) {
+                    completed.push_back(q);
+                }
+            }
+            done += completed.size();
+        }
+    }
+    return done;
+}
+
+}  // namespace
+
+BENCH_CASE(quest_events) {
+    size_t count = run.option("quests", 5000);
+    const uint32_t subjects = 50000;  // distinct enemy, item and room names events can carry
+    std::mt19937 rng(5);
+
+    std::vector<uint32_t> questSubject(count);
+    for (auto& subject : questSubject) {
+        subject = rng() % subjects;
+    }
+    // Most events concern nothing any quest waits for, as in play
+    const size_t events = 20000;
+    std::vector<uint32_t> eventSubject(events);
+    for (auto& subject : eventSubject) {
+        subject = rng() % subjects;
+    }
+
+    std::vector<std::string> names(subjects);
+    for (uint32_t s = 0; s < subjects; ++s) {
+        names[s] = "Subject " + std::to_string(s);
+    }
+
+    run.measure("publish/linear-scan", events, [&] {
+        std::vector<LegacyQuest> quests;
+        for (size_t q = 0; q < count; ++q) {
+            quests.push_back({"quest" + std::to_string(q), names[questSubject[q]], false});
+        }
+        size_t done = 0;
+        for (uint32_t subject : eventSubject) {
+            done += legacyPublish(quests, names[subject]);
+        }
+        bench::doNotOptimize(done);
+    });
+
+    run.measure("publish/bus", events, [&] {
+        QuestBus bus;
+        for (size_t q = 0; q < count; ++q) {
+            bus.add(GameEvent::EnemyDefeated, questSubject[q], 1 + q % 3);
+        }
+        size_t done = 0;
+        for (uint32_t subject : eventSubject) {
+            bus.publish(GameEvent::EnemyDefeated, subject, [&](QuestBus::QuestId) { ++done; });
+        }
+        bench::doNotOptimize(done);
+    });
+    run.note(std::to_string(count) + " quests");
+}
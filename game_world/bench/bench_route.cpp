@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_harness.h"
+#include "dungeon_generator.h"
+#include "route_index.h"
+
+/*
+ * Route planning on a generated maze of 10^6 rooms (--rooms=<n>): building
+ * the RouteIndex, shortest routes between random rooms with the landmark-guided
+ * search and with a plain breadth-first search, routes to rooms a short walk
+ * away, the reachability check, routes to the nearest room with a name, and
+ * keeping the index exact as exits are added.
+ */
+
+namespace {
+
+using RoomId = WorldStore::RoomId;
+
+// What a bot would do without an index: breadth-first from `from` until `to` comes up
+size_t bfsRoute(const WorldStore& world, RoomId from, RoomId to, std::vector<RoomId>& parent,
+                std::vector<RoomId>& queue) {
+    std::fill(parent.begin(), parent.end(), WorldStore::NO_ROOM);
+    parent[from] = from;
+    queue.assign(1, from);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        RoomId room = queue[head];
+        if (room == to) {
+            break;
+        }
+        for (RoomId next : world.exits(room)) {
+            if (next != WorldStore::NO_ROOM && parent[next] == WorldStore::NO_ROOM) {
+                parent[next] = room;
+                queue.push_back(next);
+            }
+        }
+    }
+    size_t steps = 0;
+    for (RoomId room = to; room != from; room = parent[room]) {
+        ++steps;
+    }
+    return steps;
+}
+
+}  // namespace
+
+BENCH_CASE(route_index) {
+    GeneratorOptions options;
+    options.rooms = run.option("rooms", 1000000);
+    GeneratedDungeon dungeon = generateDungeon(options);
+    const WorldStore& world = dungeon.world;
+    size_t rooms = world.roomCount();
+
+    std::mt19937 rng(13);
+    const size_t queries = 200;
+    std::vector<std::pair<RoomId, RoomId>> pairs(queries);
+    for (auto& pair : pairs) {
+        pair = {static_cast<RoomId>(rng() % rooms), static_cast<RoomId>(rng() % rooms)};
+    }
+
+    RouteIndex index;
+    run.measure("build/" + std::to_string(rooms) + "-rooms", 1, [&] { index.build(world); });
+    run.note(std::to_string(index.memoryBytes() >> 20) + " MiB");
+
+    std::vector<RoomId> path;
+    size_t steps = 0;
+    size_t visited = 0;
+    run.measure("route/landmarks", queries, [&] {
+        steps = 0;
+        visited = 0;
+        for (const auto& [from, to] : pairs) {
+            index.route(world, from, to, path);
+            steps += path.size();
+            visited += index.lastVisited();
+        }
+    });
+    run.note(std::to_string(steps / queries) + " steps, " + std::to_string(visited / queries) +
+             " rooms visited per route");
+
+    // What a bot mostly plans: a room a short walk away, here 50 steps along a long route
+    std::vector<std::pair<RoomId, RoomId>> nearby;
+    for (const auto& [from, to] : pairs) {
+        index.route(world, from, to, path);
+        if (path.size() >= 50) {
+            nearby.emplace_back(from, path[49]);
+        }
+    }
+    run.measure("route/nearby", nearby.size(), [&] {
+        visited = 0;
+        for (const auto& [from, to] : nearby) {
+            index.route(world, from, to, path);
+            visited += index.lastVisited();
+        }
+    });
+    run.note(std::to_string(visited / std::max<size_t>(nearby.size(), 1)) +
+             " rooms visited per route");
+
+    std::vector<RoomId> parent(rooms);
+    std::vector<RoomId> queue;
+    const size_t bfsQueries = 20;
+    run.measure("route/bfs", bfsQueries, [&] {
+        size_t total = 0;
+        for (size_t q = 0; q < bfsQueries; ++q) {
+            total += bfsRoute(world, pairs[q].first, pairs[q].second, parent, queue);
+        }
+        bench::doNotOptimize(total);
+    });
+
+    run.measure("connected", queries, [&] {
+        size_t connected = 0;
+        for (const auto& [from, to] : pairs) {
+            connected += index.connected(world, from, to);
+        }
+        bench::doNotOptimize(connected);
+    });
+
+    uint32_t crypt = world.findName("Crypt");
+    run.measure("route-to-name/nearest-crypt", queries, [&] {
+        for (const auto& pair : pairs) {
+            index.routeToName(world, pair.first, crypt, path);
+        }
+    });
+
+    // New passages between neighbouring rooms: patch the index, or rebuild it
+    WorldStore carved = world.cloneInMemory();
+    RouteIndex incremental;
+    incremental.build(carved);
+    const size_t carves = 100;
+    run.measure("exit-added/incremental", carves, [&] {
+        for (size_t c = 0; c < carves; ++c) {
+            auto room = static_cast<RoomId>(1 + rng() % (rooms - 1));
+            carved.setExit(room, 'w', room - 1);
+            carved.setExit(room - 1, 'e', room);
+            incremental.exitAdded(carved, room, room - 1);
+            incremental.exitAdded(carved, room - 1, room);
+        }
+    });
+    run.measure("exit-added/rebuild", 1, [&] { incremental.build(carved); });
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "world_store.h"
+
+/*
+ * World traversal: the previous pointer-based layout against WorldStore
+ *
+ * Both layouts hold the same square grid of rooms (default 10^6, override
+ * with --rooms=N). Each visit does what move()/describeLocation() do: check
+ * the room's enemy, read its treasure and follow an exit.
+ */
+
+namespace {
+
+// The layout GameEngine used before WorldStore, kept here for comparison
+struct LegacyEnemy {
+    std::string name;
+    int health;
+    bool isAlive() const { return health > 0; }
+};
+
+struct LegacyLocation {
+    std::string name;
+    std::string description;
+    std::unique_ptr<LegacyEnemy> enemy;
+    std::vector<std::string> treasureNames;
+    std::vector<int> treasureValues;
+    bool visited = false;
+    std::map<char, int> exits;
+};
+
+struct Worlds {
+    size_t side = 0;
+    std::vector<std::unique_ptr<LegacyLocation>> legacy;
+    WorldStore flat;
+    std::vector<int> flatEnemyHealth;
+};
+
+const char DIRECTIONS[] = {'n', 's', 'e', 'w'};
+
+Worlds buildWorlds(size_t rooms) {
+    Worlds w;
+    w.side = 1;
+    while (w.side * w.side < rooms) {
+        ++w.side;
+    }
+    size_t count = w.side * w.side;
+    std::mt19937 rng(42);
+
+    w.legacy.reserve(count);
+    w.flat.reserve(count, count / 2);
+    for (size_t i = 0; i < count; ++i) {
+        size_t x = i % w.side;
+        size_t y = i / w.side;
+        bool hasEnemy = rng() % 8 == 0;
+        bool hasTreasure = rng() % 4 == 0;
+        auto item = static_cast<ItemId>(rng() % ITEM_COUNT);
+
+        auto loc = std::make_unique<LegacyLocation>();
+        loc->name = "Room";
+        loc->description = "A generated room.";
+        int id = w.flat.addRoom("Room", "A generated room.");
+
+        auto link = [&](char dir, size_t target) {
+            loc->exits[dir] = static_cast<int>(target);
+            w.flat.setExit(id, dir, static_cast<int>(target));
+        };
+        if (y + 1 < w.side) {
+            link('n', i + w.side);
+        }
+        if (y > 0) {
+            link('s', i - w.side);
+        }
+        if (x + 1 < w.side) {
+            link('e', i + 1);
+        }
+        if (x > 0) {
+            link('w', i - 1);
+        }
+
+        if (hasEnemy) {
+            loc->enemy = std::make_unique<LegacyEnemy>(LegacyEnemy{"Goblin", 0});
+            w.flat.addEnemy(id, static_cast<uint32_t>(w.flatEnemyHealth.size()));
+            w.flatEnemyHealth.push_back(0);
+        }
+        if (hasTreasure) {
+            loc->treasureNames.emplace_back(itemDefinition(item).name);
+            loc->treasureValues.push_back(itemDefinition(item).value);
+            w.flat.addTreasure(id, item);
+        }
+        w.legacy.push_back(std::move(loc));
+    }
+    return w;
+}
+
+long long visitLegacy(Worlds& w, int& room, char dir) {
+    LegacyLocation& loc = *w.legacy[room];
+    long long sum = 0;
+    if (loc.enemy && loc.enemy->isAlive()) {
+        return sum;
+    }
+    for (size_t i = 0; i < loc.treasureNames.size(); ++i) {
+        sum += loc.treasureValues[i];
+    }
+    loc.visited = true;
+    auto it = loc.exits.find(dir);
+    if (it != loc.exits.end()) {
+        room = it->second;
+    }
+    return sum;
+}
+
+long long visitFlat(Worlds& w, int& room, char dir) {
+    long long sum = 0;
+    if (w.flat.enemyCount(room) > 0 && w.flatEnemyHealth[w.flat.enemyBegin(room)] > 0) {
+        return sum;
+    }
+    size_t treasure = w.flat.treasureCount(room);
+    for (size_t i = 0; i < treasure; ++i) {
+        sum += w.flat.treasureValue(room, i);
+    }
+    w.flat.markVisited(room);
+    int target = w.flat.exit(room, dir);
+    if (target != WorldStore::NO_ROOM) {
+        room = target;
+    }
+    return sum;
+}
+
+}  // namespace
+
+BENCH_CASE(world_traversal) {
+    size_t rooms = run.option("rooms", 1000000);
+    Worlds w = buildWorlds(rooms);
+    size_t count = w.side * w.side;
+
+    // Random walk: the access pattern of a player or bot moving room to room
+    std::vector<char> walk(count);
+    std::mt19937 rng(7);
+    for (auto& d : walk) {
+        d = DIRECTIONS[rng() % 4];
+    }
+
+    // Random order: the access pattern of teleports and scattered lookups
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    run.measure("walk/legacy", count, [&] {
+        int room = static_cast<int>(count / 2);
+        long long sum = 0;
+        for (char d : walk) {
+            sum += visitLegacy(w, room, d);
+        }
+        bench::doNotOptimize(sum);
+    });
+    run.measure("walk/flat", count, [&] {
+        int room = static_cast<int>(count / 2);
+        long long sum = 0;
+        for (char d : walk) {
+            sum += visitFlat(w, room, d);
+        }
+        bench::doNotOptimize(sum);
+    });
+    run.measure("random/legacy", count, [&] {
+        long long sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            int room = order[i];
+            sum += visitLegacy(w, room, walk[i]);
+        }
+        bench::doNotOptimize(sum);
+    });
+    run.measure("random/flat", count, [&] {
+        long long sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            int room = order[i];
+            sum += visitFlat(w, room, walk[i]);
+        }
+        bench::doNotOptimize(sum);
+    });
+    run.measure("scan/legacy", count, [&] {
+        long long sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            int room = static_cast<int>(i);
+            sum += visitLegacy(w, room, 'n');
+        }
+        bench::doNotOptimize(sum);
+    });
+    run.measure("scan/flat", count, [&] {
+        long long sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            int room = static_cast<int>(i);
+            sum += visitFlat(w, room, 'n');
+        }
+        bench::doNotOptimize(sum);
+    });
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Fixed-block pool
+ *
+ * Entries live in blocks of BLOCK_SIZE that are allocated once and never
+ * moved, so growing the pool copies nothing and a slot number stays valid
+ * until it is released. Released slots are reused before new ones are taken,
+ * and a block is only freed when the whole pool is cleared.
+ */
+template <typename T, size_t BLOCK_SIZE = 4096>
+class BlockPool {
+    static_assert((BLOCK_SIZE & (BLOCK_SIZE - 1)) == 0, "BLOCK_SIZE must be a power of two");
+
+   public:
+    using Slot = uint32_t;
+    static constexpr Slot NONE = ~Slot{0};
+
+    Slot allocate() {
+        if (!free_.empty()) {
+            Slot slot = free_.back();
+            free_.pop_back();
+            return slot;
+        }
+        if (used_ == blocks_.size() * BLOCK_SIZE) {
+            blocks_.push_back(std::make_unique<T[]>(BLOCK_SIZE));
+        }
+        return used_++;
+    }
+
+    void release(Slot slot) { free_.push_back(slot); }
+
+    void clear() {
+        blocks_.clear();
+        free_.clear();
+        used_ = 0;
+    }
+
+    T& operator[](Slot slot) { return blocks_[slot / BLOCK_SIZE][slot % BLOCK_SIZE]; }
+    const T& operator[](Slot slot) const { return blocks_[slot / BLOCK_SIZE][slot % BLOCK_SIZE]; }
+
+    size_t memoryBytes() const {
+        return blocks_.size() * BLOCK_SIZE * sizeof(T) +
+               blocks_.capacity() * sizeof(blocks_[0]) + free_.capacity() * sizeof(Slot);
+    }
+
+   private:
+    std::vector<std::unique_ptr<T[]>> blocks_;
+    std::vector<Slot> free_;
+    Slot used_ = 0;  // slots handed out at least once
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "enemy_store.h"
+#include "item_registry.h"
+#include "world_store.h"
+
+/**
+ * The built-in seven-room dungeon as constant tables
+ *
+ * Rooms, exits, enemies and treasure are constexpr data in read-only memory,
+ * checked at compile time. builtin::dungeon() turns them into a WorldStore and
+ * an EnemyStore once per process; every game copies those, which shares their
+ * layout and roster and allocates only what play changes (visited flags,
+ * treasure left, enemy health).
+ */
+namespace builtin {
+
+constexpr int8_t NO_EXIT = -1;
+static_assert(NO_EXIT == WorldStore::NO_ROOM);
+
+struct Exits {
+    int8_t north = NO_EXIT;
+    int8_t south = NO_EXIT;
+    int8_t east = NO_EXIT;
+    int8_t west = NO_EXIT;
+};
+
+struct RoomDefinition {
+    std::string_view name;
+    std::string_view description;
+    Exits exits;
+};
+
+// Enemies and treasure are listed in room order (their spans are contiguous)
+struct EnemyDefinition {
+    int8_t room;
+    std::string_view name;
+    int health;
+    int attack;
+    uint8_t flags;
+};
+
+struct TreasureDefinition {
+    int8_t room;
+    ItemId item;
+};
+
+inline constexpr std::array<RoomDefinition, 7> ROOMS = {{
+    {"Dungeon Entrance",
+     "You stand at the entrance of a dark dungeon. Torches flicker on the walls.",
+     {.north = 1}},
+    {"Grand Hall", "A vast hall with crumbling pillars. You hear echoes in the distance.",
+     {.north = 4, .south = 0, .east = 2, .west = 3}},
+    {"Old Armory", "Broken weapons and armor litter the floor.", {.west = 1}},
+    {"Storage Room", "Dusty crates and barrels fill this room.", {.east = 1}},
+    {"Guard Room", "This room once housed the dungeon guards. Bones scatter the floor.",
+     {.north = 5, .south = 1}},
+    {"Treasure Chamber", "Gold and jewels glitter in the torchlight!", {.north = 6, .south = 4}},
+    {"Dragon's Lair", "A massive chamber. The air is thick with smoke and the smell of sulfur.",
+     {.south = 5}},
+}};
+
+inline constexpr std::array<EnemyDefinition, 3> ENEMIES = {{
+    {1, "Goblin Scout", 30, 8, 0},
+    {4, "Skeleton Warrior", 50, 12, 0},
+    {6, "Ancient Dragon", 150, 25, EnemyStore::BOSS | EnemyStore::CASTER},
+}};
+
+inline constexpr std::array<TreasureDefinition, 9> TREASURE = {{
+    {1, items::RUSTY_DAGGER},
+    {2, items::IRON_SWORD},
+    {2, items::LEATHER_ARMOR},
+    {3, items::HEALTH_POTION},
+    {3, items::GOLD_COINS},
+    {4, items::STEEL_SWORD},
+    {5, items::MAGIC_AMULET},
+    {5, items::GOLD_PILE},
+    {6, items::DRAGON_HOARD},
+}};
+
+// Every exit leads to a room that leads straight back; enemies and treasure are in room order
+constexpr bool tablesAreConsistent() {
+    constexpr auto rooms = static_cast<int8_t>(ROOMS.size());
+    auto valid = [](int8_t exit) { return exit == NO_EXIT || (exit >= 0 && exit < rooms); };
+    for (int8_t room = 0; room < rooms; ++room) {
+        const Exits& exits = ROOMS[room].exits;
+        if (!valid(exits.north) || !valid(exits.south) || !valid(exits.east) ||
+            !valid(exits.west) ||
+            (exits.north != NO_EXIT && ROOMS[exits.north].exits.south != room) ||
+            (exits.south != NO_EXIT && ROOMS[exits.south].exits.north != room) ||
+            (exits.east != NO_EXIT && ROOMS[exits.east].exits.west != room) ||
+            (exits.west != NO_EXIT && ROOMS[exits.west].exits.east != room)) {
+            return false;
+        }
+    }
+    for (size_t i = 1; i < ENEMIES.size(); ++i) {
+        if (ENEMIES[i].room < ENEMIES[i - 1].room) {
+            return false;
+        }
+    }
+    for (size_t i = 1; i < TREASURE.size(); ++i) {
+        if (TREASURE[i].room < TREASURE[i - 1].room) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(tablesAreConsistent());
+
+struct Dungeon {
+    WorldStore world;
+    EnemyStore enemies;
+};
+
+// Built from the tables on first use (thread-safe); games copy it
+inline const Dungeon& dungeon() {
+    static const Dungeon built = [] {
+        Dungeon d;
+        d.world.reserve(ROOMS.size(), TREASURE.size());
+        d.enemies.reserve(ENEMIES.size());
+        size_t enemy = 0;
+        size_t treasure = 0;
+        for (size_t r = 0; r < ROOMS.size(); ++r) {
+            const RoomDefinition& definition = ROOMS[r];
+            auto room = d.world.addRoom(definition.name, definition.description);
+            const Exits& exits = definition.exits;
+            d.world.setExit(room, 'n', exits.north);
+            d.world.setExit(room, 's', exits.south);
+            d.world.setExit(room, 'e', exits.east);
+            d.world.setExit(room, 'w', exits.west);
+            for (; enemy < ENEMIES.size() && ENEMIES[enemy].room == room; ++enemy) {
+                const EnemyDefinition& e = ENEMIES[enemy];
+                d.world.addEnemy(room, d.enemies.add(e.name, e.health, e.attack, e.flags));
+            }
+            for (; treasure < TREASURE.size() && TREASURE[treasure].room == room; ++treasure) {
+                d.world.addTreasure(room, TREASURE[treasure].item);
+            }
+        }
+        return d;
+    }();
+    return built;
+}
+
+}  // namespace builtin
@@ -0,0 +1,275 @@
+#include "combat_sim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+#include "game_random.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    include <immintrin.h>
+#    define CPP_QUEST_HAS_AVX2_PATH 1
+#endif
+
+namespace {
+
+// Fights that last this long are stopped and counted as losses (only possible with zero damage)
+constexpr int MAX_ROUNDS = 100000;
+
+// murmur3 32-bit finalizer (only 32-bit multiplies, so it vectorizes)
+uint32_t mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    return x ^ (x >> 16);
+}
+
+// Each fight owns a xorshift32 stream, so results don't depend on how fights are batched.
+// `key` is splitMix64(seed), split into the two halves used here.
+uint32_t fightSeed(uint64_t key, size_t fight) {
+    uint32_t x = static_cast<uint32_t>(fight) * 0x9E3779B9u + static_cast<uint32_t>(key);
+    return (mix32(x) ^ static_cast<uint32_t>(key >> 32)) | 1u;
+}
+
+uint32_t nextState(uint32_t x) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Uniform in [0, n) from the top 16 bits
+int roll(uint32_t& state, int n) {
+    state = nextState(state);
+    return static_cast<int>(((state >> 16) * static_cast<uint32_t>(n)) >> 16);
+}
+
+void record(CombatStats& stats, bool won, int hpLeft, int rounds) {
+    stats.wins += won;
+    stats.rounds += static_cast<uint64_t>(rounds);
+    ++stats.hpLeft[static_cast<size_t>(hpLeft)];
+}
+
+// The loop from GameEngine::fight(): the player strikes, then the enemy if it still stands
+void simulateScalar(const CombatRules& rules, const CombatSetup& setup, uint64_t key,
+                    size_t begin, size_t end, CombatStats& stats) {
+    for (size_t i = begin; i < end; ++i) {
+        uint32_t state = fightSeed(key, i);
+        int enemyHealth = setup.enemyHealth;
+        int playerHealth = setup.playerHealth;
+        bool won = false;
+        int rounds = 0;
+
+        while (rounds < MAX_ROUNDS) {
+            ++rounds;
+            enemyHealth -= setup.playerAttack + roll(state, rules.playerRoll);
+            if (enemyHealth <= 0) {
+                won = true;
+                break;
+            }
+            playerHealth -= setup.enemyDamage + roll(state, rules.enemyRoll);
+            if (playerHealth <= 0) {
+                playerHealth = 0;
+                break;
+            }
+        }
+        record(stats, won, won ? playerHealth : 0, rounds);
+    }
+}
+
+#ifdef CPP_QUEST_HAS_AVX2_PATH
+
+__attribute__((target("avx2"))) __m256i nextState8(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+    return _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+}
+
+__attribute__((target("avx2"))) __m256i mix32x8(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0x85EBCA6Bu)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 13));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0xC2B2AE35u)));
+    return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+
+__attribute__((target("avx2"))) __m256i roll8(__m256i state, __m256i n) {
+    return _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(state, 16), n), 16);
+}
+
+// Eight fights per step, one per 32-bit lane; finished lanes are masked out until all are done
+__attribute__((target("avx2"))) void simulateAvx2(const CombatRules& rules,
+                                                  const CombatSetup& setup, uint64_t key,
+                                                  size_t begin, size_t end, CombatStats& stats) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i playerAttack = _mm256_set1_epi32(setup.playerAttack);
+    const __m256i enemyDamage = _mm256_set1_epi32(setup.enemyDamage);
+    const __m256i playerRoll = _mm256_set1_epi32(rules.playerRoll);
+    const __m256i enemyRoll = _mm256_set1_epi32(rules.enemyRoll);
+
+    // fightSeed() for eight consecutive fights
+    const __m256i golden = _mm256_set1_epi32(static_cast<int>(0x9E3779B9u));
+    const __m256i laneOffsets =
+        _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), golden);
+    const __m256i keyLow = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(key)));
+    const __m256i keyHigh = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(key >> 32)));
+
+    alignas(32) int32_t hpOut[8];
+    alignas(32) int32_t wonOut[8];
+    alignas(32) int32_t roundsOut[8];
+
+    for (size_t base = begin; base + 8 <= end; base += 8) {
+        uint32_t first = static_cast<uint32_t>(base) * 0x9E3779B9u;
+        __m256i x = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first)), laneOffsets), keyLow);
+        __m256i state = _mm256_or_si256(_mm256_xor_si256(mix32x8(x), keyHigh), one);
+        __m256i enemyHealth = _mm256_set1_epi32(setup.enemyHealth);
+        __m256i playerHealth = _mm256_set1_epi32(setup.playerHealth);
+        __m256i done = zero;
+        __m256i won = zero;
+        __m256i rounds = zero;
+
+        for (int round = 0; round < MAX_ROUNDS; ++round) {
+            __m256i active = _mm256_andnot_si256(done, _mm256_cmpeq_epi32(zero, zero));
+            rounds = _mm256_sub_epi32(rounds, active);  // active lanes are -1
+
+            state = nextState8(state);
+            __m256i hit = _mm256_add_epi32(playerAttack, roll8(state, playerRoll));
+            enemyHealth = _mm256_sub_epi32(enemyHealth, _mm256_and_si256(hit, active));
+            __m256i killed = _mm256_and_si256(active, _mm256_cmpgt_epi32(one, enemyHealth));
+            won = _mm256_or_si256(won, killed);
+            done = _mm256_or_si256(done, killed);
+            active = _mm256_andnot_si256(killed, active);
+
+            // Lanes that just won draw too; their stream is not used again
+            state = nextState8(state);
+            __m256i taken = _mm256_add_epi32(enemyDamage, roll8(state, enemyRoll));
+            playerHealth = _mm256_sub_epi32(playerHealth, _mm256_and_si256(taken, active));
+            done = _mm256_or_si256(
+                done, _mm256_and_si256(active, _mm256_cmpgt_epi32(one, playerHealth)));
+
+            if (_mm256_movemask_epi8(done) == -1) {
+                break;
+            }
+        }
+
+        __m256i hpLeft = _mm256_and_si256(won, _mm256_max_epi32(playerHealth, zero));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(hpOut), hpLeft);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(wonOut), won);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(roundsOut), rounds);
+        for (int lane = 0; lane < 8; ++lane) {
+            record(stats, wonOut[lane] != 0, hpOut[lane], roundsOut[lane]);
+        }
+    }
+}
+
+#endif
+
+std::string percent(double fraction) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << fraction * 100.0 << "%";
+    return text.str();
+}
+
+}  // namespace
+
+double CombatStats::meanHpLeft() const {
+    uint64_t total = 0;
+    for (size_t hp = 0; hp < hpLeft.size(); ++hp) {
+        total += hp * hpLeft[hp];
+    }
+    return fights ? static_cast<double>(total) / fights : 0.0;
+}
+
+int CombatStats::hpPercentile(double fraction) const {
+    double target = fraction * static_cast<double>(fights);
+    uint64_t seen = 0;
+    for (size_t hp = 0; hp < hpLeft.size(); ++hp) {
+        seen += hpLeft[hp];
+        if (static_cast<double>(seen) >= target) {
+            return static_cast<int>(hp);
+        }
+    }
+    return static_cast<int>(hpLeft.empty() ? 0 : hpLeft.size() - 1);
+}
+
+bool combatSimHasAvx2() {
+#ifdef CPP_QUEST_HAS_AVX2_PATH
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+CombatStats simulateCombat(const CombatRules& rules, const CombatSetup& setup,
+                           const CombatSimOptions& options) {
+    CombatStats stats;
+    stats.fights = options.fights;
+    stats.hpLeft.assign(static_cast<size_t>(std::max(setup.playerHealth, 0)) + 1, 0);
+
+    const uint64_t key = splitMix64(options.seed);
+    size_t vectorEnd = 0;
+#ifdef CPP_QUEST_HAS_AVX2_PATH
+    if (!options.forceScalar && combatSimHasAvx2()) {
+        vectorEnd = options.fights - options.fights % 8;
+        simulateAvx2(rules, setup, key, 0, vectorEnd, stats);
+    }
+#endif
+    simulateScalar(rules, setup, key, vectorEnd, options.fights, stats);
+    return stats;
+}
+
+void printCombatReport(std::ostream& out, const CombatRules& rules, const CombatRoster& roster,
+                       const CombatSimOptions& options) {
+    std::vector<CombatWeapon> loadouts = {{"(none)", 0}};
+    if (rules.weaponsEquip) {
+        loadouts.insert(loadouts.end(), roster.weapons.begin(), roster.weapons.end());
+    }
+
+    out << "Combat simulation\n";
+    out << "  Player:       " << roster.playerHealth << " HP, " << roster.playerAttack
+        << " attack\n";
+    out << "  Fights:       " << options.fights << " per matchup (seed " << options.seed << ")\n";
+    out << "  Path:         "
+        << (!options.forceScalar && combatSimHasAvx2() ? "AVX2 (8 fights per step)" : "scalar")
+        << "\n\n";
+
+    out << std::left << std::setw(20) << "Enemy" << std::setw(16) << "Weapon" << std::right
+        << std::setw(8) << "Win" << std::setw(10) << "Mean HP" << std::setw(6) << "p10"
+        << std::setw(6) << "p50" << std::setw(6) << "p90" << std::setw(8) << "Rounds" << "\n";
+
+    size_t totalFights = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& enemy : roster.enemies) {
+        for (const auto& weapon : loadouts) {
+            CombatSetup setup{roster.playerHealth, roster.playerAttack + weapon.bonus,
+                              enemy.health,
+                              rules.enemyUsesAttack ? enemy.attack : rules.fixedEnemyBase};
+            CombatStats stats = simulateCombat(rules, setup, options);
+            totalFights += stats.fights;
+
+            std::string weaponLabel = weapon.name;
+            if (weapon.bonus > 0) {
+                weaponLabel += " +" + std::to_string(weapon.bonus);
+            }
+            out << std::left << std::setw(20) << enemy.name << std::setw(16) << weaponLabel
+                << std::right << std::setw(8) << percent(stats.winRate()) << std::setw(10)
+                << std::fixed << std::setprecision(1) << stats.meanHpLeft() << std::setw(6)
+                << stats.hpPercentile(0.10) << std::setw(6) << stats.hpPercentile(0.50)
+                << std::setw(6) << stats.hpPercentile(0.90) << std::setw(8)
+                << static_cast<double>(stats.rounds) / std::max<size_t>(stats.fights, 1)
+                << "\n";
+        }
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    out << std::defaultfloat << std::setprecision(6);
+    out << "\nHP columns are health left after the fight (0 for a loss).\n";
+    out << "  Elapsed:      " << seconds << " s ("
+        << static_cast<long long>(seconds > 0.0 ? totalFights / seconds : 0) << " fights/s)\n";
+}
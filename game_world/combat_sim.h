@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "session_modules.h"
+
+/**
+ * Monte Carlo combat simulator
+ *
+ * Plays the same fight GameEngine::fight() plays, millions of times, to
+ * measure how often the player wins and how much health is left. Fights are
+ * independent, so they run eight at a time in AVX2 lanes when the CPU has
+ * AVX2, and one at a time otherwise. Every fight draws from its own generator
+ * seeded from (seed, fight index), so both paths give identical results.
+ */
+
+// Damage rules shared by GameEngine::fight() and the simulator
+struct CombatRules {
+    int playerRoll;        // the player hits for attack + weapon bonus + [0, playerRoll)
+    bool enemyUsesAttack;  // enemies hit for their attack (or fixedEnemyBase) + [0, enemyRoll)
+    int fixedEnemyBase;
+    int enemyRoll;
+    bool weaponsEquip;  // looted swords and daggers add to the player's attack
+};
+
+// The rules of a game with these session modules
+constexpr CombatRules engineCombatRules(ModuleSet modules = COMPILED_MODULES) {
+    CombatRules rules{5, true, 0, 3, false};
+    if (modules.has(Module::Combat)) {
+        // Entities don't expose their attack; every enemy hits for 10-14
+        rules.enemyUsesAttack = false;
+        rules.fixedEnemyBase = 10;
+        rules.enemyRoll = 5;
+    }
+    rules.weaponsEquip = modules.has(Module::Weapons);
+    return rules;
+}
+
+struct CombatEnemy {
+    std::string name;
+    int health;
+    int attack;
+};
+
+struct CombatWeapon {
+    std::string name;
+    int bonus;
+};
+
+// What a dungeon offers to fight with and against (GameEngine::combatRoster())
+struct CombatRoster {
+    int playerHealth = 0;
+    int playerAttack = 0;
+    std::vector<CombatEnemy> enemies;
+    std::vector<CombatWeapon> weapons;
+};
+
+struct CombatSetup {
+    int playerHealth;
+    int playerAttack;  // including the weapon bonus
+    int enemyHealth;
+    int enemyDamage;  // base damage per enemy hit, before the roll
+};
+
+struct CombatSimOptions {
+    size_t fights = 1000000;
+    uint64_t seed = 1;
+    bool forceScalar = false;
+};
+
+struct CombatStats {
+    size_t fights = 0;
+    size_t wins = 0;
+    uint64_t rounds = 0;
+    // hpLeft[h] = fights that ended with the player on h health (0 for every loss)
+    std::vector<uint64_t> hpLeft;
+
+    double winRate() const { return fights ? static_cast<double>(wins) / fights : 0.0; }
+    double meanHpLeft() const;
+    // Smallest h such that at least `fraction` of fights ended with h health or less
+    int hpPercentile(double fraction) const;
+};
+
+bool combatSimHasAvx2();
+
+CombatStats simulateCombat(const CombatRules& rules, const CombatSetup& setup,
+                           const CombatSimOptions& options);
+
+// Every enemy in the roster against no weapon and each weapon (when weapons equip)
+void printCombatReport(std::ostream& out, const CombatRules& rules, const CombatRoster& roster,
+                       const CombatSimOptions& options);
@@ -0,0 +1,215 @@
+#include "command_journal.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+namespace {
+
+constexpr char MAGIC[4] = {'C', 'Q', 'J', 'L'};
+constexpr uint32_t VERSION = 5;
+constexpr uint32_t BYTE_ORDER_TAG = 0x01020304;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t baseSize;
+    uint64_t baseChecksum;
+};
+
+// Opcode, draw count (varint) and argument
+constexpr uint64_t MAX_RECORD = 1 + 10 + CommandJournal::MAX_ARGUMENT;
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+size_t varintSize(uint64_t value) {
+    size_t size = 1;
+    for (; value >= 0x80; value >>= 7) {
+        ++size;
+    }
+    return size;
+}
+
+bool getVarint(const char* data, size_t size, size_t& offset, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < size; shift += 7) {
+        auto byte = static_cast<unsigned char>(data[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Catches torn writes and most garbage (including zero fill) at the end of the file
+char checkByte(const char* data, size_t size) {
+    return static_cast<char>(snapshotChecksum(data, size) & 0xFF);
+}
+
+}  // namespace
+
+CommandJournal::~CommandJournal() {
+    commit();
+    close();
+}
+
+void CommandJournal::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool CommandJournal::create(const std::string& path, const SnapshotWriter& base) {
+    close();
+    pending_.clear();
+    records_ = 0;
+    bytes_ = 0;
+    path_ = path;
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_TAG;
+    header.baseSize = base.size();
+    header.baseChecksum = snapshotChecksum(base.data(), base.size());
+
+    // A crash while compacting leaves the old journal in place
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(base.data(), 1, base.size(), file) == base.size();
+    written = std::fclose(file) == 0 && written;
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(temporary, path, error);
+    }
+    if (!written || error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    bytes_ = sizeof(header) + base.size();
+    file_ = std::fopen(path.c_str(), "ab");
+    return file_ != nullptr;
+}
+
+bool CommandJournal::reopen(const std::string& path, size_t validSize) {
+    close();
+    pending_.clear();
+    records_ = 0;
+    path_ = path;
+
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) > validSize && !error) {
+        std::filesystem::resize_file(path, validSize, error);
+    }
+    if (error) {
+        return false;
+    }
+    bytes_ = validSize;
+    file_ = std::fopen(path.c_str(), "ab");
+    return file_ != nullptr;
+}
+
+void CommandJournal::append(const JournalRecord& record) {
+    std::string_view argument = record.argument.substr(0, MAX_ARGUMENT);
+    size_t start = pending_.size();
+    putVarint(pending_, 1 + varintSize(record.draws) + argument.size());
+    size_t payload = pending_.size();
+    pending_.push_back(static_cast<char>(record.command));
+    putVarint(pending_, record.draws);
+    pending_.append(argument);
+    pending_.push_back(checkByte(pending_.data() + payload, pending_.size() - payload));
+    bytes_ += pending_.size() - start;
+    ++records_;
+}
+
+bool CommandJournal::commit() {
+    if (pending_.empty() || !file_) {
+        return file_ != nullptr;
+    }
+    bool written = std::fwrite(pending_.data(), 1, pending_.size(), file_) == pending_.size();
+    written = std::fflush(file_) == 0 && written;
+    pending_.clear();
+    return written;
+}
+
+SnapshotStatus JournalReader::open(const std::string& path) {
+    data_.clear();
+    offset_ = 0;
+    error_.clear();
+    // A journal that is there but can't be read must not be started over
+    errno = 0;
+    std::error_code ignored;
+    int failure = std::filesystem::is_directory(path, ignored) ? EISDIR : 0;
+    std::ifstream file;
+    if (failure == 0) {
+        file.open(path, std::ios::binary);
+        failure = file.is_open() ? 0 : (errno != 0 ? errno : ENOENT);
+    }
+    if (failure == ENOENT) {
+        return SnapshotStatus::Missing;
+    }
+    if (failure != 0) {
+        error_ = path + ": " + std::strerror(failure);
+        return SnapshotStatus::Unreadable;
+    }
+    data_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    Header header{};
+    if (data_.size() < sizeof(header)) {
+        return SnapshotStatus::Corrupt;
+    }
+    std::memcpy(&header, data_.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.byteOrder != BYTE_ORDER_TAG ||
+        header.baseSize > data_.size() - sizeof(header) ||
+        snapshotChecksum(data_.data() + sizeof(header), header.baseSize) != header.baseChecksum) {
+        return SnapshotStatus::Corrupt;
+    }
+    baseOffset_ = sizeof(header);
+    baseSize_ = header.baseSize;
+    offset_ = baseOffset_ + baseSize_;
+    return SnapshotStatus::Ok;
+}
+
+SnapshotReader JournalReader::base() const {
+    return SnapshotReader(data_.data() + baseOffset_, baseSize_);
+}
+
+bool JournalReader::next(JournalRecord& record) {
+    const char* data = data_.data();
+    size_t size = data_.size();
+    size_t at = offset_;
+    uint64_t length = 0;
+    if (!getVarint(data, size, at, length) || length == 0 || length > MAX_RECORD ||
+        length + 1 > size - at || data[at + length] != checkByte(data + at, length)) {
+        return false;
+    }
+
+    size_t end = at + length;
+    auto opcode = static_cast<uint8_t>(data[at++]);
+    if (opcode >= COMMAND_COUNT || !getVarint(data, end, at, record.draws)) {
+        return false;
+    }
+    record.command = static_cast<Command>(opcode);
+    record.argument = std::string_view(data + at, end - at);
+    offset_ = end + 1;
+    return true;
+}
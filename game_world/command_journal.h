@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command_table.h"
+#include "snapshot.h"
+
+/**
+ * Append-only command journal for crash recovery
+ *
+ * A journal file is a base state followed by the commands played since:
+ *
+ *   header   magic, version, byte-order tag, base size and checksum
+ *   base     a snapshot payload (game, world and generator state)
+ *   records  one per command: varint length, opcode, varint RNG draws,
+ *            argument bytes, one check byte
+ *
+ * Records are a few bytes each and are buffered until commit(), which appends
+ * them with one write. Replaying the base plus the records rebuilds the game
+ * exactly, because the engine's only source of randomness is in the base; the
+ * recorded draw count of each command lets replay notice when it diverges.
+ *
+ * create() rewrites the journal around a new base (written to a temporary file
+ * and renamed over the old one), which is how the log is compacted.
+ */
+
+struct JournalRecord {
+    Command command = Command::Unknown;
+    std::string_view argument;
+    uint64_t draws = 0;  // random values the command drew
+};
+
+class CommandJournal {
+   public:
+    // Longer arguments are cut short; no command reads that far into its argument
+    static constexpr size_t MAX_ARGUMENT = 256;
+
+    CommandJournal() = default;
+    ~CommandJournal();
+    CommandJournal(const CommandJournal&) = delete;
+    CommandJournal& operator=(const CommandJournal&) = delete;
+
+    // Replaces whatever is at path with a journal holding only the base; false on I/O error
+    bool create(const std::string& path, const SnapshotWriter& base);
+    // Continues an existing journal whose valid part ends at validSize (a torn tail is cut off)
+    bool reopen(const std::string& path, size_t validSize);
+
+    void append(const JournalRecord& record);
+    // Writes the pending records; false on I/O error
+    bool commit();
+
+    size_t records() const { return records_; }  // since the base
+    size_t bytes() const { return bytes_; }      // file size once committed
+    const std::string& path() const { return path_; }
+
+   private:
+    void close();
+
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    std::string pending_;
+    size_t records_ = 0;
+    size_t bytes_ = 0;
+};
+
+/**
+ * A journal file read into memory. Records refer into it, so it has to outlive them.
+ */
+class JournalReader {
+   public:
+    // Missing only when no file exists at path; Unreadable, with error(), when it can't be read
+    SnapshotStatus open(const std::string& path);
+    const std::string& error() const { return error_; }
+
+    SnapshotReader base() const;
+
+    // Next intact record; false at the end or at a torn or garbled tail
+    bool next(JournalRecord& record);
+
+    // Bytes up to the end of the last record returned by next()
+    size_t validSize() const { return offset_; }
+    bool atEnd() const { return offset_ == data_.size(); }
+
+   private:
+    std::vector<char> data_;
+    size_t baseOffset_ = 0;
+    size_t baseSize_ = 0;
+    size_t offset_ = 0;
+    std::string error_;
+};
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Command table and parser
+ *
+ * Every command word (including aliases) is resolved to an opcode with one
+ * hash, one table probe and one string compare. The hash seed is searched at
+ * compile time so that no two words share a slot (a perfect hash); adding a
+ * word that breaks this fails the build instead of slowing lookups down.
+ *
+ * The parser reads commands and their arguments from a line. A line may hold
+ * several commands ("n fight loot 2 go east"); each command takes only the
+ * arguments its opcode accepts, so scripts and interactive input share it.
+ * Commands that name a room ("goto Old Library") take the rest of the line.
+ */
+
+enum class Command : uint8_t {
+    Unknown,
+    North,
+    South,
+    East,
+    West,
+    Go,
+    Look,
+    Fight,
+    Flee,
+    Loot,
+    Stats,
+    Inventory,
+    Quests,
+    Perf,
+    Save,
+    Load,
+    Export,
+    Import,
+    Goto,
+    Path,
+    Quit,  // keep last: COMMAND_COUNT follows it
+};
+
+inline constexpr size_t COMMAND_COUNT = static_cast<size_t>(Command::Quit) + 1;
+
+// Name used for the command in reports
+constexpr std::string_view commandName(Command command) {
+    constexpr std::string_view NAMES[COMMAND_COUNT] = {
+        "unknown", "north", "south", "east", "west",   "go",     "look",
+        "fight",   "flee",  "loot",  "stats", "inv",   "quests", "perf",
+        "save",    "load",  "export", "import", "goto", "path",  "quit",
+    };
+    return NAMES[static_cast<size_t>(command)];
+}
+
+enum class ArgumentKind { None, Direction, OptionalNumber, RestOfLine };
+
+constexpr ArgumentKind argumentKind(Command command) {
+    switch (command) {
+        case Command::Go:
+            return ArgumentKind::Direction;
+        case Command::Loot:
+            return ArgumentKind::OptionalNumber;
+        case Command::Goto:
+        case Command::Path:
+            return ArgumentKind::RestOfLine;
+        default:
+            return ArgumentKind::None;
+    }
+}
+
+struct ParsedCommand {
+    Command command = Command::Unknown;
+    std::string_view verb;      // the word as typed
+    std::string_view argument;  // empty when none was given
+};
+
+namespace command_table {
+
+struct Entry {
+    std::string_view word;
+    Command command;
+};
+
+inline constexpr Entry ENTRIES[] = {
+    {"n", Command::North},       {"north", Command::North},   {"s", Command::South},
+    {"south", Command::South},   {"e", Command::East},        {"east", Command::East},
+    {"w", Command::West},        {"west", Command::West},     {"go", Command::Go},
+    {"look", Command::Look},     {"l", Command::Look},        {"fight", Command::Fight},
+    {"attack", Command::Fight},  {"flee", Command::Flee},     {"run", Command::Flee},
+    {"loot", Command::Loot},     {"take", Command::Loot},     {"stats", Command::Stats},
+    {"inv", Command::Inventory}, {"i", Command::Inventory},   {"inventory", Command::Inventory},
+    {"quests", Command::Quests}, {"perf", Command::Perf},     {"save", Command::Save},
+    {"load", Command::Load},     {"export", Command::Export}, {"import", Command::Import},
+    {"goto", Command::Goto},     {"path", Command::Path},     {"quit", Command::Quit},
+    {"exit", Command::Quit},
+};
+
+inline constexpr size_t ENTRY_COUNT = sizeof(ENTRIES) / sizeof(ENTRIES[0]);
+inline constexpr size_t TABLE_SIZE = 64;  // power of two, at least twice ENTRY_COUNT
+static_assert(TABLE_SIZE >= 2 * ENTRY_COUNT);
+
+constexpr uint32_t hash(std::string_view word, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : word) {
+        h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return (h ^ (h >> 15)) & (TABLE_SIZE - 1);
+}
+
+constexpr bool isPerfect(uint32_t seed) {
+    std::array<bool, TABLE_SIZE> used{};
+    for (const auto& entry : ENTRIES) {
+        uint32_t slot = hash(entry.word, seed);
+        if (used[slot]) {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t findSeed() {
+    for (uint32_t seed = 1; seed < 100000; ++seed) {
+        if (isPerfect(seed)) {
+            return seed;
+        }
+    }
+    return 0;
+}
+
+inline constexpr uint32_t SEED = findSeed();
+static_assert(SEED != 0, "No collision-free seed for the command table; grow TABLE_SIZE");
+
+// Slot -> index into ENTRIES, or -1 for an empty slot
+constexpr std::array<int8_t, TABLE_SIZE> buildSlots() {
+    std::array<int8_t, TABLE_SIZE> slots{};
+    for (auto& slot : slots) {
+        slot = -1;
+    }
+    for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+        slots[hash(ENTRIES[i].word, SEED)] = static_cast<int8_t>(i);
+    }
+    return slots;
+}
+
+inline constexpr std::array<int8_t, TABLE_SIZE> SLOTS = buildSlots();
+
+}  // namespace command_table
+
+constexpr Command resolveCommand(std::string_view word) {
+    int8_t index = command_table::SLOTS[command_table::hash(word, command_table::SEED)];
+    if (index < 0 || command_table::ENTRIES[index].word != word) {
+        return Command::Unknown;
+    }
+    return command_table::ENTRIES[index].command;
+}
+
+static_assert(resolveCommand("north") == Command::North);
+static_assert(resolveCommand("inventory") == Command::Inventory);
+static_assert(resolveCommand("dance") == Command::Unknown);
+static_assert(commandName(Command::Quit) == "quit" && commandName(Command::Perf) == "perf");
+
+// Direction letter for a movement command or direction word ('\0' if it is neither)
+constexpr char commandDirection(Command command) {
+    switch (command) {
+        case Command::North:
+            return 'n';
+        case Command::South:
+            return 's';
+        case Command::East:
+            return 'e';
+        case Command::West:
+            return 'w';
+        default:
+            return '\0';
+    }
+}
+
+class CommandParser {
+   public:
+    // The parsed commands refer into `line`, which must outlive them
+    void reset(std::string_view line) {
+        line_ = line;
+        pos_ = 0;
+    }
+
+    // Next command on the line; false once the line is used up
+    bool next(ParsedCommand& out) {
+        std::string_view word = nextWord();
+        if (word.empty()) {
+            return false;
+        }
+
+        out.verb = word;
+        out.command = resolveCommand(word);
+        out.argument = {};
+
+        switch (argumentKind(out.command)) {
+            case ArgumentKind::None:
+                break;
+            case ArgumentKind::Direction:
+                out.argument = takeWordIf([](std::string_view arg) {
+                    return commandDirection(resolveCommand(arg)) != '\0';
+                });
+                break;
+            case ArgumentKind::OptionalNumber:
+                out.argument = takeWordIf(isNumber);
+                break;
+            case ArgumentKind::RestOfLine:
+                out.argument = restOfLine();
+                break;
+        }
+        return true;
+    }
+
+   private:
+    static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    // Digits, possibly after a '-', so that "loot -1" is a bad item number, not a bare loot
+    static bool isNumber(std::string_view word) {
+        if (!word.empty() && word[0] == '-') {
+            word.remove_prefix(1);
+        }
+        if (word.empty()) {
+            return false;
+        }
+        for (char c : word) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view nextWord() {
+        while (pos_ < line_.size() && isSpace(line_[pos_])) {
+            ++pos_;
+        }
+        size_t start = pos_;
+        while (pos_ < line_.size() && !isSpace(line_[pos_])) {
+            ++pos_;
+        }
+        return line_.substr(start, pos_ - start);
+    }
+
+    // The next word if accepts(word); otherwise nothing, and the word is left for the next
+    // command
+    template <typename Accepts>
+    std::string_view takeWordIf(Accepts accepts) {
+        size_t saved = pos_;
+        std::string_view word = nextWord();
+        if (accepts(word)) {
+            return word;
+        }
+        pos_ = saved;
+        return {};
+    }
+
+    // Everything left on the line, without surrounding blanks
+    std::string_view restOfLine() {
+        size_t start = pos_;
+        size_t end = line_.size();
+        while (start < end && isSpace(line_[start])) {
+            ++start;
+        }
+        while (end > start && isSpace(line_[end - 1])) {
+            --end;
+        }
+        pos_ = line_.size();
+        return line_.substr(start, end - start);
+    }
+
+    std::string_view line_;
+    size_t pos_ = 0;
+};
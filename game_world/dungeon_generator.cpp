@@ -0,0 +1,315 @@
+#include "dungeon_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "game_random.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <sys/resource.h>
+#endif
+
+namespace {
+
+// Rooms per unit of parallel work; fixed so output never depends on thread count
+constexpr size_t CHUNK_ROOMS = size_t{1} << 16;
+
+const char* const ROOM_NAMES[] = {
+    "Dusty Corridor", "Flooded Cellar", "Collapsed Tunnel", "Fungal Grotto",
+    "Forgotten Shrine", "Narrow Passage", "Crypt", "Barracks",
+    "Old Library", "Torture Chamber", "Wine Cellar", "Echoing Cavern",
+    "Spider Nest", "Mine Shaft", "Sunken Chapel", "Guard Post",
+};
+
+const char* const ROOM_DESCRIPTIONS[] = {
+    "Cold stone walls close in around you.",
+    "Water drips steadily from the ceiling.",
+    "The air smells of damp earth and old smoke.",
+    "Scratch marks cover the floor and walls.",
+    "Faded banners hang from rusted hooks.",
+    "A faint draft carries distant whispers.",
+    "Cobwebs stretch across every corner.",
+    "Broken furniture is piled against one wall.",
+};
+
+const ItemId TREASURE[] = {
+    items::RUSTY_DAGGER, items::IRON_SWORD,  items::LEATHER_ARMOR, items::HEALTH_POTION,
+    items::GOLD_COINS,   items::STEEL_SWORD, items::MAGIC_AMULET,  items::GOLD_PILE,
+};
+
+constexpr ItemId BOSS_TREASURE = items::DRAGON_HOARD;
+
+constexpr size_t ROOM_NAME_COUNT = sizeof(ROOM_NAMES) / sizeof(ROOM_NAMES[0]);
+constexpr size_t DESCRIPTION_COUNT = sizeof(ROOM_DESCRIPTIONS) / sizeof(ROOM_DESCRIPTIONS[0]);
+constexpr size_t TREASURE_COUNT = sizeof(TREASURE) / sizeof(TREASURE[0]);
+
+// Everything the generator decides about one room, derived from (seed, room)
+struct RoomPlan {
+    uint32_t nameIndex;
+    uint32_t descriptionIndex;
+    bool linkWest;
+    bool linkSouth;
+    int enemyKind;  // -1 for none
+    uint16_t treasure;
+    uint64_t treasureBits;
+};
+
+class Planner {
+   public:
+    Planner(uint64_t seed, size_t rooms)
+        : seed_(splitMix64(seed)), rooms_(rooms), width_(gridWidth(rooms)) {
+        const auto& kinds = generatorEnemyKinds();
+        for (size_t k = 0; k < kinds.size(); ++k) {
+            if (kinds[k].boss) {
+                bossKind_ = static_cast<int>(k);
+            } else {
+                ++regularKinds_;
+            }
+        }
+    }
+
+    size_t width() const { return width_; }
+    size_t bossRoom() const { return rooms_ - 1; }
+
+    RoomPlan plan(size_t room) const {
+        uint64_t h = splitMix64(seed_ ^ room);
+        size_t x = room % width_;
+        size_t y = room / width_;
+
+        RoomPlan p{};
+        p.nameIndex = static_cast<uint32_t>(h % ROOM_NAME_COUNT);
+        p.descriptionIndex = static_cast<uint32_t>((h >> 8) % DESCRIPTION_COUNT);
+
+        // Maze carving: link toward row 0 / column 0, which always reaches room 0
+        if (x > 0 && y > 0) {
+            bool west = (h >> 16) & 1;
+            bool loop = ((h >> 17) & 15) == 0;
+            p.linkWest = west || loop;
+            p.linkSouth = !west || loop;
+        } else {
+            p.linkWest = x > 0;
+            p.linkSouth = y > 0;
+        }
+
+        p.enemyKind = -1;
+        if (room == bossRoom() && room != 0) {
+            p.enemyKind = bossKind_;
+            p.treasure = 1;
+            return p;
+        }
+        if (room != 0 && ((h >> 21) & 7) == 0) {
+            p.enemyKind = static_cast<int>((h >> 24) % regularKinds_);
+        }
+
+        uint64_t roll = (h >> 32) & 7;
+        p.treasure = roll < 5 ? 0 : (roll < 7 ? 1 : 2);
+        p.treasureBits = splitMix64(h);
+        return p;
+    }
+
+   private:
+    static size_t gridWidth(size_t rooms) {
+        size_t w = 1;
+        while (w * w < rooms) {
+            ++w;
+        }
+        return w;
+    }
+
+    uint64_t seed_;
+    size_t rooms_;
+    size_t width_;
+    int bossKind_ = 0;
+    size_t regularKinds_ = 0;
+};
+
+template <typename Fn>
+void forEachChunk(size_t chunks, unsigned threads, Fn&& fn) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t c = next.fetch_add(1); c < chunks; c = next.fetch_add(1)) {
+            fn(c);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+}
+
+long peakRssKilobytes() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#    ifdef __APPLE__
+        return usage.ru_maxrss / 1024;  // bytes on macOS
+#    else
+        return usage.ru_maxrss;
+#    endif
+    }
+#endif
+    return 0;
+}
+
+}  // namespace
+
+const std::vector<EnemyKind>& generatorEnemyKinds() {
+    static const std::vector<EnemyKind> kinds = {
+        {"Goblin Scout", 30, 8, false},
+        {"Skeleton Warrior", 50, 12, false},
+        {"Giant Rat", 15, 5, false},
+        {"Cave Troll", 80, 15, false},
+        {"Ancient Dragon", 150, 25, true},
+    };
+    return kinds;
+}
+
+GeneratedDungeon generateDungeon(const GeneratorOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+
+    GeneratedDungeon result;
+    size_t rooms =
+        std::clamp(options.rooms, GeneratorOptions::MIN_ROOMS, GeneratorOptions::MAX_ROOMS);
+    size_t chunks = (rooms + CHUNK_ROOMS - 1) / CHUNK_ROOMS;
+    unsigned threads = options.threads;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, chunks));
+
+    Planner planner(options.seed, rooms);
+    WorldStore& world = result.world;
+
+    // Strings are interned up front so the parallel passes only write ids
+    uint32_t entranceName = world.internString("Dungeon Entrance");
+    uint32_t entranceDescription = world.internString(
+        "You stand at the entrance of a dark dungeon. Torches flicker on the walls.");
+    uint32_t bossName = world.internString("Dragon's Lair");
+    uint32_t bossDescription = world.internString(
+        "A massive chamber. The air is thick with smoke and the smell of sulfur.");
+    std::vector<uint32_t> nameIds;
+    std::vector<uint32_t> descriptionIds;
+    for (const char* name : ROOM_NAMES) {
+        nameIds.push_back(world.internString(name));
+    }
+    for (const char* description : ROOM_DESCRIPTIONS) {
+        descriptionIds.push_back(world.internString(description));
+    }
+    const auto& kinds = generatorEnemyKinds();
+    std::vector<uint32_t> kindNameIds;
+    for (const auto& kind : kinds) {
+        kindNameIds.push_back(result.enemies.internName(kind.name));
+    }
+
+    // Pass 1: count enemies and treasure per chunk to find each chunk's output offsets
+    std::vector<size_t> enemyOffset(chunks + 1, 0);
+    std::vector<size_t> treasureOffset(chunks + 1, 0);
+    forEachChunk(chunks, threads, [&](size_t c) {
+        size_t end = std::min(rooms, (c + 1) * CHUNK_ROOMS);
+        size_t enemies = 0;
+        size_t treasure = 0;
+        for (size_t room = c * CHUNK_ROOMS; room < end; ++room) {
+            RoomPlan p = planner.plan(room);
+            enemies += p.enemyKind >= 0;
+            treasure += p.treasure;
+        }
+        enemyOffset[c + 1] = enemies;
+        treasureOffset[c + 1] = treasure;
+    });
+    for (size_t c = 0; c < chunks; ++c) {
+        enemyOffset[c + 1] += enemyOffset[c];
+        treasureOffset[c + 1] += treasureOffset[c];
+    }
+
+    world.resizeRooms(rooms);
+    world.resizeTreasure(treasureOffset[chunks]);
+    result.enemies.resize(enemyOffset[chunks]);
+
+    // Pass 2: fill rooms in place
+    size_t width = planner.width();
+    forEachChunk(chunks, threads, [&](size_t c) {
+        size_t end = std::min(rooms, (c + 1) * CHUNK_ROOMS);
+        size_t enemy = enemyOffset[c];
+        size_t slot = treasureOffset[c];
+
+        for (size_t room = c * CHUNK_ROOMS; room < end; ++room) {
+            RoomPlan p = planner.plan(room);
+            auto id = static_cast<WorldStore::RoomId>(room);
+
+            if (room == 0) {
+                world.setRoomText(id, entranceName, entranceDescription);
+            } else if (room == planner.bossRoom()) {
+                world.setRoomText(id, bossName, bossDescription);
+            } else {
+                world.setRoomText(id, nameIds[p.nameIndex], descriptionIds[p.descriptionIndex]);
+            }
+
+            // Each link also writes the neighbor's opposite slot, which no other room touches
+            if (p.linkWest) {
+                auto west = static_cast<WorldStore::RoomId>(room - 1);
+                world.setExit(id, 'w', west);
+                world.setExit(west, 'e', id);
+            }
+            if (p.linkSouth) {
+                auto south = static_cast<WorldStore::RoomId>(room - width);
+                world.setExit(id, 's', south);
+                world.setExit(south, 'n', id);
+            }
+
+            if (p.enemyKind >= 0) {
+                const EnemyKind& kind = kinds[p.enemyKind];
+                world.setEnemySpan(id, static_cast<uint32_t>(enemy), 1);
+                result.enemies.set(static_cast<EnemyStore::EnemyId>(enemy),
+                                   kindNameIds[p.enemyKind], kind.health, kind.attack,
+                                   kind.boss ? EnemyStore::BOSS | EnemyStore::CASTER : 0);
+                ++enemy;
+            }
+
+            world.setTreasureSpan(id, static_cast<uint32_t>(slot), p.treasure);
+            if (room == planner.bossRoom() && room != 0) {
+                world.setTreasureSlot(slot++, BOSS_TREASURE);
+                continue;
+            }
+            for (uint16_t t = 0; t < p.treasure; ++t) {
+                size_t kind = (p.treasureBits >> (16 * t)) % TREASURE_COUNT;
+                world.setTreasureSlot(slot++, TREASURE[kind]);
+            }
+        }
+    });
+
+    result.stats.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.stats.threads = threads;
+    result.stats.worldBytes = world.memoryBytes();
+    result.stats.enemyBytes = result.enemies.memoryBytes();
+    result.stats.peakRssKilobytes = peakRssKilobytes();
+    return result;
+}
+
+void printGeneratorReport(std::ostream& out, const GeneratorOptions& options,
+                          const GeneratedDungeon& dungeon) {
+    const GeneratorStats& stats = dungeon.stats;
+    size_t rooms = dungeon.world.roomCount();
+    double mib = 1024.0 * 1024.0;
+
+    out << "Dungeon generation\n";
+    out << "  Rooms:        " << rooms << " (seed " << options.seed << ")\n";
+    out << "  Enemies:      " << dungeon.enemies.size() << "\n";
+    out << "  Threads:      " << stats.threads << "\n";
+    out << "  Elapsed:      " << stats.seconds * 1000.0 << " ms ("
+        << (stats.seconds > 0.0 ? static_cast<long long>(rooms / stats.seconds) : 0)
+        << " rooms/s)\n";
+    out << "  World data:   " << (stats.worldBytes + stats.enemyBytes) / mib << " MiB ("
+        << static_cast<double>(stats.worldBytes + stats.enemyBytes) / rooms << " bytes/room)\n";
+    if (stats.peakRssKilobytes > 0) {
+        out << "  Peak RSS:     " << stats.peakRssKilobytes / 1024.0 << " MiB\n";
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <vector>
+
+#include "enemy_store.h"
+#include "world_store.h"
+
+/**
+ * Seeded procedural dungeon generator
+ *
+ * Rooms are laid out on a square grid and carved into a maze where every room
+ * links back toward the entrance (room 0), so the whole dungeon is connected;
+ * a few extra links add loops. Room 0 is the entrance and the last room holds
+ * the Ancient Dragon.
+ *
+ * Every per-room decision comes from a hash of (seed, room), and rooms are
+ * generated in fixed-size chunks spread over worker threads. The result is
+ * therefore identical for a given seed whatever the thread count.
+ */
+
+struct EnemyKind {
+    const char* name;
+    int health;
+    int attack;
+    bool boss;
+};
+
+// Enemy templates the generator places
+const std::vector<EnemyKind>& generatorEnemyKinds();
+
+struct GeneratorOptions {
+    // The entrance and the boss's room; smaller counts are raised to this
+    static constexpr size_t MIN_ROOMS = 2;
+    // Largest dungeon generated; room ids are 32-bit, and larger counts are lowered to this
+    static constexpr size_t MAX_ROOMS = 10'000'000;
+
+    size_t rooms = 1000;
+    uint64_t seed = 1;
+    // 0 means one worker per hardware thread
+    unsigned threads = 0;
+};
+
+static_assert(GeneratorOptions::MAX_ROOMS <=
+                  static_cast<size_t>(std::numeric_limits<WorldStore::RoomId>::max()),
+              "every generated room needs a RoomId");
+
+struct GeneratorStats {
+    double seconds = 0.0;
+    unsigned threads = 0;
+    size_t worldBytes = 0;
+    size_t enemyBytes = 0;
+    long peakRssKilobytes = 0;  // whole process; 0 where unsupported
+};
+
+struct GeneratedDungeon {
+    WorldStore world;
+    // Indexed by the rooms' enemy spans in world (at most one enemy per room)
+    EnemyStore enemies;
+    GeneratorStats stats;
+};
+
+GeneratedDungeon generateDungeon(const GeneratorOptions& options);
+
+void printGeneratorReport(std::ostream& out, const GeneratorOptions& options,
+                          const GeneratedDungeon& dungeon);
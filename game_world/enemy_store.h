@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "snapshot.h"
+#include "string_table.h"
+
+/**
+ * Enemies as components
+ *
+ * Every enemy is a row index into parallel arrays (name id, health, max
+ * health, attack, flags), the same struct-of-arrays layout as WorldStore.
+ * Rooms own a [begin, begin + count) span of enemy ids (see
+ * WorldStore::enemyBegin), so a room can hold any number of enemies and
+ * combat reads and writes plain integers: no virtual calls and no string
+ * compares. Names are interned in a StringTable and referenced by id.
+ *
+ * As in WorldStore, what combat never changes (names, max health, attack,
+ * flags) is a Roster shared by copies; a copy owns only the health column.
+ */
+class EnemyStore {
+   public:
+    using EnemyId = uint32_t;
+
+    // Flag bits
+    static constexpr uint8_t BOSS = 1;    // defeating it wins the game
+    static constexpr uint8_t CASTER = 2;  // a mage rather than a fighter (shown as its type)
+
+    void clear() { *this = EnemyStore(); }
+
+    void reserve(size_t enemies) {
+        Roster& roster = edit();
+        roster.nameId.reserve(enemies);
+        roster.maxHealth.reserve(enemies);
+        roster.attack.reserve(enemies);
+        roster.flags.reserve(enemies);
+        health_.reserve(enemies);
+    }
+
+    EnemyId add(std::string_view name, int health, int attack, uint8_t flags = 0) {
+        Roster& roster = edit();
+        roster.nameId.push_back(roster.names.intern(name));
+        roster.maxHealth.push_back(health);
+        roster.attack.push_back(attack);
+        roster.flags.push_back(flags);
+        health_.push_back(health);
+        return static_cast<EnemyId>(roster.nameId.size() - 1);
+    }
+
+    // Bulk construction for generators, as in WorldStore: size the columns, intern the
+    // names, then fill rows in place (distinct rows may be filled from different threads)
+    void resize(size_t enemies) {
+        Roster& roster = edit();
+        roster.nameId.assign(enemies, 0);
+        roster.maxHealth.assign(enemies, 0);
+        roster.attack.assign(enemies, 0);
+        roster.flags.assign(enemies, 0);
+        health_.assign(enemies, 0);
+    }
+    uint32_t internName(std::string_view name) { return edit().names.intern(name); }
+    void set(EnemyId enemy, uint32_t nameId, int health, int attack, uint8_t flags) {
+        Roster& roster = edit();
+        roster.nameId[enemy] = nameId;
+        roster.maxHealth[enemy] = health;
+        roster.attack[enemy] = attack;
+        roster.flags[enemy] = flags;
+        health_[enemy] = health;
+    }
+
+    size_t size() const { return roster_->nameId.size(); }
+
+    const std::string& name(EnemyId enemy) const {
+        return roster_->names.text(roster_->nameId[enemy]);
+    }
+    uint32_t nameId(EnemyId enemy) const { return roster_->nameId[enemy]; }
+    // Id of an enemy name, or StringTable::NONE if no enemy has it
+    uint32_t findName(std::string_view name) const { return roster_->names.find(name); }
+    int health(EnemyId enemy) const { return health_[enemy]; }
+    int maxHealth(EnemyId enemy) const { return roster_->maxHealth[enemy]; }
+    int attack(EnemyId enemy) const { return roster_->attack[enemy]; }
+    bool alive(EnemyId enemy) const { return health_[enemy] > 0; }
+    bool is(EnemyId enemy, uint8_t flag) const { return (roster_->flags[enemy] & flag) != 0; }
+
+    // Returns the health left (never below 0)
+    int damage(EnemyId enemy, int amount) {
+        int left = health_[enemy] - amount;
+        health_[enemy] = left < 0 ? 0 : left;
+        return health_[enemy];
+    }
+    void setHealth(EnemyId enemy, int health) { health_[enemy] = health; }
+
+    // Bytes held by the roster (shared or not) and the health column
+    size_t memoryBytes() const {
+        const Roster& roster = *roster_;
+        size_t bytes = (roster.nameId.capacity() + health_.capacity() +
+                        roster.maxHealth.capacity() + roster.attack.capacity()) *
+                           sizeof(int32_t) +
+                       roster.flags.capacity() + roster.names.memoryBytes();
+        return bytes;
+    }
+
+    void writeSnapshot(SnapshotWriter& out) const {
+        const Roster& roster = *roster_;
+        roster.names.writeSnapshot(out);
+        out.putColumn(roster.nameId);
+        out.putColumn(health_);
+        out.putColumn(roster.maxHealth);
+        out.putColumn(roster.attack);
+        out.putColumn(roster.flags);
+    }
+
+    bool readSnapshot(SnapshotReader& in) {
+        auto roster = std::make_shared<Roster>();
+        if (!roster->names.readSnapshot(in)) {
+            return false;
+        }
+        bool ok = in.getColumn(roster->nameId) && in.getColumn(health_) &&
+                  in.getColumn(roster->maxHealth) && in.getColumn(roster->attack) &&
+                  in.getColumn(roster->flags);
+        roster_ = std::move(roster);
+        return ok && isConsistent();
+    }
+
+   private:
+    // What combat never changes
+    struct Roster {
+        StringTable names;
+        std::vector<uint32_t> nameId;
+        std::vector<int32_t> maxHealth;
+        std::vector<int32_t> attack;
+        std::vector<uint8_t> flags;
+    };
+
+    static const std::shared_ptr<Roster>& emptyRoster() {
+        static const std::shared_ptr<Roster> empty = std::make_shared<Roster>();
+        return empty;
+    }
+
+    // The roster for construction, copied first if another store shares it
+    Roster& edit() {
+        if (roster_.use_count() > 1) {
+            roster_ = std::make_shared<Roster>(*roster_);
+        }
+        return *roster_;
+    }
+
+    bool isConsistent() const {
+        const Roster& roster = *roster_;
+        size_t enemies = roster.nameId.size();
+        if (health_.size() != enemies || roster.maxHealth.size() != enemies ||
+            roster.attack.size() != enemies || roster.flags.size() != enemies) {
+            return false;
+        }
+        for (uint32_t id : roster.nameId) {
+            if (id >= roster.names.size()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<Roster> roster_ = emptyRoster();
+
+    // Per-enemy state
+    std::vector<int32_t> health_;
+};
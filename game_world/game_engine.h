@@ -3,14 +3,37 @@
 #include "session_config.h"
 
 #include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <random>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "bar_renderer.h"
+#include "builtin_dungeon.h"
+#include "combat_sim.h"
+#include "command_journal.h"
+#include "command_table.h"
+#include "dungeon_generator.h"
+#include "enemy_store.h"
+#include "game_metrics.h"
+#include "game_random.h"
+#include "inventory_store.h"
+#include "item_registry.h"
+#include "output_frame.h"
+#include "quest_bus.h"
+#include "route_index.h"
+#include "session_modules.h"
+#include "snapshot.h"
+#include "startup_report.h"
+#include "world_store.h"
+
 // Session integrations
 #ifdef SESSION_02_AVAILABLE
 #    include "../sessions/02_memory_realms/starter/inventory.h"
@@ -36,56 +59,42 @@
 #    include "../sessions/11_standard_library/starter/stl_game.h"
 #endif
 
-// Fallback implementations for sessions not completed
-#ifndef SESSION_02_AVAILABLE
-struct Item {
-    std::string name;
-    int value;
-    Item(const std::string& n, int v) : name(n), value(v) {}
-};
-#endif
 
-#ifndef SESSION_08_AVAILABLE
-// Fallback Enemy system
-struct Enemy {
-    std::string name;
-    int health;
-    int maxHealth;
-    int attack;
-    bool isBoss;
+// How a session ended; lets headless runs tally results without parsing output
+enum class GameOutcome { InProgress, Victory, Death, Quit, OutOfInput };
 
-    Enemy(const std::string& n, int hp, int atk, bool boss = false)
-        : name(n), health(hp), maxHealth(hp), attack(atk), isBoss(boss) {}
+/**
+ * The game, with the session modules in Modules (see session_modules.h)
+ *
+ * `#ifdef SESSION_XX_AVAILABLE` marks code that needs a session's starter
+ * code to compile; `if constexpr (WITH_...)` picks what this configuration
+ * runs, so a module left out costs nothing. GameEngine plays with every
+ * module compiled in.
+ */
+template <ModuleSet Modules>
+class BasicGameEngine {
+    // game_bench drives the private steps (describeLocation(), fight(), ...) directly
+    friend struct EngineBenchAccess;
 
-    bool isAlive() const { return health > 0; }
-    const std::string& getName() const { return name; }
-    int getHealth() const { return health; }
-    std::string getType() const { return isBoss ? "Boss" : "Enemy"; }
-    void takeDamage(int amount) { health = std::max(0, health - amount); }
-};
-#endif
+    static_assert((Modules.bits & ~COMPILED_MODULES.bits) == 0,
+                  "a module's session must be compiled in to select it");
 
-// Location system
-struct Location {
-    std::string name;
-    std::string description;
-#ifdef SESSION_08_AVAILABLE
-    std::unique_ptr<Entity> enemy;
-#else
-    std::unique_ptr<Enemy> enemy;
-#endif
-    std::vector<std::string> treasureNames;
-    std::vector<int> treasureValues;
-    bool visited;
-    std::map<char, int> exits;
-
-    Location(const std::string& n, const std::string& desc)
-        : name(n), description(desc), visited(false) {}
-};
+    static constexpr bool WITH_INVENTORY = Modules.has(Module::Inventory);
+    static constexpr bool WITH_SAVELOAD = Modules.has(Module::SaveLoad);
+    static constexpr bool WITH_WEAPONS = Modules.has(Module::Weapons);
+    static constexpr bool WITH_COMBAT = Modules.has(Module::Combat);
+    static constexpr bool WITH_QUESTS = Modules.has(Module::Quests);
 
-class GameEngine {
    private:
     bool running_;
+    GameOutcome outcome_;
+
+    // I/O (std::cin/std::cout for interactive play, anything else for headless runs).
+    // Each turn is composed in out_ and written to the sink once, before the next prompt.
+    std::istream& in_;
+    std::unique_ptr<OutputSink> ownedSink_;  // set when constructed from a std::ostream
+    OutputFrame out_;
+    std::string savePath_;
 
     // Player stats
     std::string playerName_;
@@ -96,709 +105,1380 @@ class GameEngine {
     int playerLevel_;
     std::string currentLocationName_;
 
+    // What the player carries; snapshots, export and the listing read it
+    InventoryStore items_;
 #ifdef SESSION_02_AVAILABLE
+    // Session 2's Inventory only exposes a count and its own display, so it mirrors items_.
+    // Null until the first loot or load (see inventory()).
     std::unique_ptr<Inventory> inventory_;
-#else
-    std::vector<Item> inventory_;
 #endif
 
 #ifdef SESSION_04_AVAILABLE
     std::unique_ptr<Weapon> equippedWeapon_;
+    std::string equippedWeaponName_;
 #endif
 
+    // Quest ids are indexes into QUESTS (no quests without the quest module). questManager_
+    // mirrors completions for the quest log; it is null until the log is first shown (see
+    // questLog()).
 #ifdef SESSION_11_AVAILABLE
     std::unique_ptr<QuestManager> questManager_;
 #endif
+    QuestBus quests_;
 
-    // Dungeon
-    std::vector<std::unique_ptr<Location>> dungeon_;
+    // Dungeon (each room owns a span of enemy ids in enemies_)
+    WorldStore world_;
+    EnemyStore enemies_;
     int currentLocation_;
     bool bossDefeated_;
 
-    // RNG
-    std::mt19937 rng_;
+    // Routes for goto and path; the index is built on first use in each world
+    RouteIndex routes_;
+    std::vector<WorldStore::RoomId> route_;
 
-   public:
-    GameEngine()
-        : running_(false), playerName_("Hero"), playerHealth_(100), playerMaxHealth_(100),
-          playerAttack_(15), playerGold_(0), playerLevel_(1),
-          currentLocationName_("Dungeon Entrance"), currentLocation_(0), bossDefeated_(false),
-          rng_(std::random_device{}()) {
-#ifdef SESSION_02_AVAILABLE
-        inventory_ = std::make_unique<Inventory>(20);
+    // Chunk file for the rooms when the world is streamed; empty to keep it in memory
+    std::string streamPath_;
+    size_t residentChunks_ = 0;
+
+    // All of the engine's random draws come from here (seed it for reproducible runs). An
+    // unseeded game is seeded from std::random_device on its first draw (see rng()).
+    GameRng rng_;
+    bool rngSeeded_ = false;
+
+    // Commands played since the journal's base state; null when not journaling
+    std::unique_ptr<CommandJournal> journal_;
+
+#if CPP_QUEST_METRICS
+    GameMetrics metrics_;
+    std::string metricsPath_;  // JSON written here by shutdown(); empty for none
 #endif
-#ifdef SESSION_11_AVAILABLE
-        questManager_ = std::make_unique<QuestManager>();
+
+   public:
+    explicit BasicGameEngine(std::istream& in = std::cin, std::ostream& out = std::cout)
+        : BasicGameEngine(in, std::make_unique<StreamSink>(out), nullptr) {}
+
+    // With a startup report, construction marks its steps in it
+    BasicGameEngine(std::istream& in, OutputSink& sink, StartupReport* startup = nullptr)
+        : BasicGameEngine(in, nullptr, &sink, startup) {}
+
+   private:
+    BasicGameEngine(std::istream& in, std::unique_ptr<OutputSink> ownedSink, OutputSink* sink,
+                    StartupReport* startup = nullptr)
+        : running_(false), outcome_(GameOutcome::InProgress), in_(in),
+          ownedSink_(std::move(ownedSink)), out_(sink ? *sink : *ownedSink_),
+          savePath_("dungeon_save"), playerName_("Hero"), playerHealth_(100),
+          playerMaxHealth_(100), playerAttack_(15), playerGold_(0), playerLevel_(1),
+          currentLocationName_("Dungeon Entrance"), currentLocation_(0), bossDefeated_(false) {
         initializeQuests();
-#endif
+        if (startup) {
+            startup->mark("engine: construct");
+        }
         createDungeon();
+        if (startup) {
+            startup->mark("engine: built-in dungeon");
+        }
     }
 
+   public:
+    // Puts back the built-in dungeon, replacing whatever world was loaded. The tables are
+    // shared; only visited flags, treasure and enemy health are this game's own.
     void createDungeon() {
-        // Entrance
-        auto loc0 = std::make_unique<Location>(
-            "Dungeon Entrance",
-            "You stand at the entrance of a dark dungeon. Torches flicker on the walls.");
-        loc0->exits['n'] = 1;
-        dungeon_.push_back(std::move(loc0));
-
-        // Hall
-        auto loc1 = std::make_unique<Location>(
-            "Grand Hall", "A vast hall with crumbling pillars. You hear echoes in the distance.");
-        loc1->exits['s'] = 0;
-        loc1->exits['e'] = 2;
-        loc1->exits['w'] = 3;
-        loc1->exits['n'] = 4;
-#ifdef SESSION_08_AVAILABLE
-        loc1->enemy = std::make_unique<Warrior>("Goblin Scout", 30, 8, 5);
-#else
-        loc1->enemy = std::make_unique<Enemy>("Goblin Scout", 30, 8);
-#endif
-        loc1->treasureNames.push_back("Rusty Dagger");
-        loc1->treasureValues.push_back(10);
-        dungeon_.push_back(std::move(loc1));
-
-        // Armory
-        auto loc2 =
-            std::make_unique<Location>("Old Armory", "Broken weapons and armor litter the floor.");
-        loc2->exits['w'] = 1;
-        loc2->treasureNames.push_back("Iron Sword");
-        loc2->treasureValues.push_back(50);
-        loc2->treasureNames.push_back("Leather Armor");
-        loc2->treasureValues.push_back(40);
-        dungeon_.push_back(std::move(loc2));
-
-        // Storage
-        auto loc3 =
-            std::make_unique<Location>("Storage Room", "Dusty crates and barrels fill this room.");
-        loc3->exits['e'] = 1;
-        loc3->treasureNames.push_back("Health Potion");
-        loc3->treasureValues.push_back(25);
-        loc3->treasureNames.push_back("Gold Coins");
-        loc3->treasureValues.push_back(100);
-        dungeon_.push_back(std::move(loc3));
-
-        // Guard Room
-        auto loc4 = std::make_unique<Location>(
-            "Guard Room", "This room once housed the dungeon guards. Bones scatter the floor.");
-        loc4->exits['s'] = 1;
-        loc4->exits['n'] = 5;
-#ifdef SESSION_08_AVAILABLE
-        loc4->enemy = std::make_unique<Warrior>("Skeleton Warrior", 50, 12, 8);
-#else
-        loc4->enemy = std::make_unique<Enemy>("Skeleton Warrior", 50, 12);
-#endif
-        loc4->treasureNames.push_back("Steel Sword");
-        loc4->treasureValues.push_back(100);
-        dungeon_.push_back(std::move(loc4));
-
-        // Treasure Room
-        auto loc5 = std::make_unique<Location>("Treasure Chamber",
-                                               "Gold and jewels glitter in the torchlight!");
-        loc5->exits['s'] = 4;
-        loc5->exits['n'] = 6;
-        loc5->treasureNames.push_back("Magic Amulet");
-        loc5->treasureValues.push_back(200);
-        loc5->treasureNames.push_back("Gold Pile");
-        loc5->treasureValues.push_back(500);
-        dungeon_.push_back(std::move(loc5));
-
-        // Boss Room
-        auto loc6 = std::make_unique<Location>(
-            "Dragon's Lair",
-            "A massive chamber. The air is thick with smoke and the smell of sulfur.");
-        loc6->exits['s'] = 5;
-#ifdef SESSION_08_AVAILABLE
-        loc6->enemy = std::make_unique<Mage>("Ancient Dragon", 150, 25, 100);
-#else
-        loc6->enemy = std::make_unique<Enemy>("Ancient Dragon", 150, 25, true);
-#endif
-        loc6->treasureNames.push_back("Dragon Hoard");
-        loc6->treasureValues.push_back(5000);
-        dungeon_.push_back(std::move(loc6));
+        world_ = builtin::dungeon().world.cloneInMemory();
+        enemies_ = builtin::dungeon().enemies;
+        worldReplaced();
+    }
+
+    // Replaces the built-in dungeon with a procedurally generated one
+    void loadDungeon(const GeneratedDungeon& dungeon) {
+        world_ = dungeon.world.cloneInMemory();
+        enemies_ = dungeon.enemies;
+        currentLocation_ = 0;
+        currentLocationName_ = world_.name(0);
+        worldReplaced();
     }
 
-    void initialize() {
-        std::cout << "\n";
-        std::cout << "╔════════════════════════════════════════╗\n";
-        std::cout << "║     C++ QUEST: DUNGEON CRAWLER         ║\n";
-        std::cout << "╚════════════════════════════════════════╝\n";
-        std::cout << "\n";
+    void initialize(StartupReport* startup = nullptr) {
+        out_ << "\n";
+        out_ << "╔════════════════════════════════════════╗\n";
+        out_ << "║     C++ QUEST: DUNGEON CRAWLER         ║\n";
+        out_ << "╚════════════════════════════════════════╝\n";
+        out_ << "\n";
 
         displayAvailableSessions();
 
-        std::cout << "You are " << playerName_ << ", a brave adventurer.\n";
-        std::cout << "A dark dungeon awaits. Treasure and danger lie within!\n\n";
-
-        std::cout << "Commands:\n";
-        std::cout << "  n/s/e/w - Move north/south/east/west\n";
-        std::cout << "  look    - Examine current location\n";
-        std::cout << "  fight   - Fight enemy in current location\n";
-        std::cout << "  flee    - Run from combat\n";
-        std::cout << "  loot    - Take treasure from current location\n";
-        std::cout << "  stats   - View your character\n";
-        std::cout << "  inv     - View inventory\n";
-#ifdef SESSION_11_AVAILABLE
-        std::cout << "  quests  - View quests\n";
+        out_ << "You are " << playerName_ << ", a brave adventurer.\n";
+        out_ << "A dark dungeon awaits. Treasure and danger lie within!\n\n";
+
+        out_ << "Commands:\n";
+        out_ << "  n/s/e/w - Move north/south/east/west (or: go north)\n";
+        out_ << "  goto X  - Walk to room X (a name or room number); path X shows the way\n";
+        out_ << "  look    - Examine current location\n";
+        out_ << "  fight   - Fight enemy in current location\n";
+        out_ << "  flee    - Run from combat\n";
+        out_ << "  loot    - Take treasure from current location (loot 2: item 2 only)\n";
+        out_ << "  stats   - View your character\n";
+        out_ << "  inv     - View inventory\n";
+        if constexpr (WITH_QUESTS) {
+            out_ << "  quests  - View quests\n";
+        }
+#if CPP_QUEST_METRICS
+        out_ << "  perf    - Show engine counters and latencies\n";
 #endif
-        std::cout << "  save    - Save game\n";
-        std::cout << "  load    - Load game\n";
-        std::cout << "  quit    - Exit game\n\n";
+        out_ << "  save    - Save game\n";
+        out_ << "  load    - Load game\n";
+        out_ << "  export  - Save game as text\n";
+        out_ << "  import  - Load game from text\n";
+        out_ << "  quit    - Exit game\n\n";
+        if (startup) {
+            startup->mark("banner and sessions");
+        }
 
         running_ = true;
         describeLocation();
+        if (startup) {
+            startup->mark("first room");
+        }
     }
 
     void run() {
         if (!running_)
             return;
 
-        while (running_) {
-            std::cout << "\n> ";
-            std::string command;
-            std::cin >> command;
-
-            if (command == "n" || command == "north")
-                move('n');
-            else if (command == "s" || command == "south")
-                move('s');
-            else if (command == "e" || command == "east")
-                move('e');
-            else if (command == "w" || command == "west")
-                move('w');
-            else if (command == "look")
+        prompt();
+        std::string line;
+        while (running_ && std::getline(in_, line)) {
+            handleLine(line);
+        }
+        if (running_) {
+            outcome_ = GameOutcome::OutOfInput;
+            running_ = false;
+        }
+        out_.flush();
+    }
+
+    // Plays every command on one line of input; each turn ends with a prompt while the game
+    // goes on. Hosts that get input from elsewhere call this instead of run().
+    void handleLine(std::string_view line) {
+        CommandParser parser;
+        parser.reset(line);
+        ParsedCommand command;
+        while (running_ && parser.next(command)) {
+            execute(command);
+            checkGameOver();
+            if (running_) {
+                prompt();
+            }
+        }
+        if (journal_) {
+            journal_->commit();
+        }
+        out_.flush();
+    }
+
+    bool isRunning() const { return running_; }
+
+    // Ends the turn: the prompt goes out with the turn's output in one write
+    void prompt() {
+        out_ << "\n> ";
+        out_.flush();
+    }
+
+    // Runs one parsed command (shared by the interactive loop and scripted input)
+    void execute(const ParsedCommand& command) {
+        uint64_t draws = rng_.draws();
+#if CPP_QUEST_METRICS
+        auto start = GameMetrics::Clock::now();
+        dispatch(command);
+        metrics_.recordCommand(command.command, GameMetrics::Clock::now() - start);
+#else
+        dispatch(command);
+#endif
+        if (journal_) {
+            journalCommand(command, rng_.draws() - draws);
+        }
+    }
+
+    GameOutcome getOutcome() const { return outcome_; }
+
+    // Replaces the generator; the same seed (and commands) replays the same game
+    void seedRandom(const GameRng& rng) {
+        rng_ = rng;
+        rngSeeded_ = true;
+    }
+    void seedRandom(uint64_t seed) { seedRandom(GameRng(seed)); }
+
+    // Keeps the rooms in a chunk file at path with at most residentChunks chunks in memory,
+    // from now on and for every world loaded later
+    bool streamWorld(const std::string& path, size_t residentChunks, std::string& error) {
+        streamPath_ = path;
+        residentChunks_ = residentChunks;
+        if (!world_.streamTo(path, residentChunks)) {
+            streamPath_.clear();
+            error = "Could not write world chunks to " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // Save file path without extension: save/load use <path>.bin, export/import <path>.txt.
+    // Batch workers each use their own path.
+    void setSavePath(const std::string& path) { savePath_ = path; }
+
+#if CPP_QUEST_METRICS
+    // shutdown() writes the metrics there as JSON
+    void setMetricsPath(const std::string& path) { metricsPath_ = path; }
+    const GameMetrics& metrics() const { return metrics_; }
+#endif
+
+    /**
+     * Journals every command from here on to path, for crash recovery. If path already
+     * holds a journal, the game it records is replayed first (output discarded) and
+     * play continues from where it stopped. False, with a message, if the journal
+     * can't be written or doesn't replay in this build.
+     */
+    bool openJournal(const std::string& path, std::string& error) {
+        journal_.reset();
+        auto journal = std::make_unique<CommandJournal>();
+        JournalReader reader;
+        SnapshotStatus status = reader.open(path);
+        if (status == SnapshotStatus::Missing) {
+            journal_ = std::move(journal);
+            if (!compactJournal(path)) {
+                journal_.reset();
+                error = "Could not write journal: " + path;
+                return false;
+            }
+            return true;
+        }
+        if (status == SnapshotStatus::Unreadable) {
+            error = "Could not read journal: " + reader.error();
+            return false;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t replayed = 0;
+        if (status != SnapshotStatus::Ok || !replayJournal(reader, replayed, error)) {
+            error = error.empty() ? "Journal is damaged or from another version: " + path
+                                  : error;
+            return false;
+        }
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+        if (!journal->reopen(path, reader.validSize())) {
+            error = "Could not reopen journal: " + path;
+            return false;
+        }
+        journal_ = std::move(journal);
+        out_ << "\n📜 Recovered " << replayed << " commands from " << path << " in " << micros
+             << " µs\n";
+        if (!running_) {
+            out_ << "The journaled game had already ended.\n";
+            return true;
+        }
+        describeLocation();
+        return true;
+    }
+
+    void shutdown() {
+        out_ << "\nThanks for playing C++ Quest!\n";
+        out_ << "Keep learning and building! 🚀\n\n";
+        out_.flush();
+#if CPP_QUEST_METRICS
+        if (!metricsPath_.empty()) {
+            metrics_.worldChunks = world_.chunkStats();
+            std::ofstream(metricsPath_) << metrics_.toJson();
+        }
+#endif
+    }
+
+    // Player stats, enemies and weapons of the current dungeon, for the combat simulator.
+    // Enemies and weapons are listed once per name.
+    CombatRoster combatRoster() const {
+        CombatRoster roster;
+        roster.playerHealth = playerMaxHealth_;
+        roster.playerAttack = playerAttack_;
+
+        std::map<std::string, bool> seen;
+        for (EnemyStore::EnemyId id = 0; id < enemies_.size(); ++id) {
+            CombatEnemy enemy{enemies_.name(id), enemies_.maxHealth(id), enemies_.attack(id)};
+            if (seen.emplace(enemy.name, true).second) {
+                roster.enemies.push_back(std::move(enemy));
+            }
+        }
+
+        for (int room = 0; room < static_cast<int>(world_.roomCount()); ++room) {
+            for (size_t i = 0; i < world_.treasureCount(room); ++i) {
+                const ItemDefinition& item = itemDefinition(world_.treasureItem(room, i));
+                std::string name(item.name);
+                if (item.weaponDamage > 0 && seen.emplace(name, true).second) {
+                    roster.weapons.push_back({name, item.weaponDamage});
+                }
+            }
+        }
+        std::sort(roster.weapons.begin(), roster.weapons.end(),
+                  [](const CombatWeapon& a, const CombatWeapon& b) { return a.bonus < b.bonus; });
+        return roster;
+    }
+
+   private:
+    static constexpr CombatRules COMBAT_RULES = engineCombatRules(Modules);
+    // Commands after which the journal is rewritten around a fresh snapshot
+    static constexpr size_t JOURNAL_COMPACT_EVERY = 4096;
+
+    void journalCommand(const ParsedCommand& command, uint64_t draws) {
+        switch (command.command) {
+            case Command::Load:
+            case Command::Import:
+                // The new state came from a file the journal can't replay: start from it
+                rebaseJournal();
+                return;
+            case Command::Stats:
+            case Command::Inventory:
+            case Command::Quests:
+            case Command::Perf:
+            case Command::Path:
+            case Command::Save:
+            case Command::Export:
+            case Command::Quit:
+            case Command::Unknown:
+                return;  // no effect on the game
+            default:
+                break;
+        }
+        journal_->append({command.command, command.argument, draws});
+        if (journal_->records() >= JOURNAL_COMPACT_EVERY) {
+            rebaseJournal();
+        }
+    }
+
+    void rebaseJournal() {
+        if (!compactJournal(journal_->path())) {
+            out_ << "⚠️  Could not write the journal; it is no longer kept.\n";
+            journal_.reset();
+        }
+    }
+
+    bool compactJournal(const std::string& path) {
+        SnapshotWriter base;
+        writeSnapshot(base);
+        base.put(rng());
+        return journal_->create(path, base);
+    }
+
+    bool replayJournal(JournalReader& reader, size_t& replayed, std::string& error) {
+        SnapshotReader base = reader.base();
+        GameRng rng;
+        if (!readSnapshot(base) || !base.get(rng) || !base.atEnd()) {
+            return false;
+        }
+        seedRandom(rng);
+
+        JournalRecord record;
+        while (running_ && reader.next(record)) {
+            uint64_t draws = rng_.draws();
+            dispatch({record.command, commandName(record.command), record.argument});
+            checkGameOver();
+            out_.discard();
+            if (rng_.draws() - draws != record.draws) {
+                error = "Journal diverges from this build at command " +
+                        std::to_string(replayed + 1);
+                return false;
+            }
+            ++replayed;
+        }
+        return true;
+    }
+
+    void dispatch(const ParsedCommand& command) {
+        switch (command.command) {
+            case Command::North:
+            case Command::South:
+            case Command::East:
+            case Command::West:
+                move(commandDirection(command.command));
+                break;
+            case Command::Go: {
+                char direction = commandDirection(resolveCommand(command.argument));
+                if (direction == '\0') {
+                    out_ << "Go where? Try 'go north'.\n";
+                } else {
+                    move(direction);
+                }
+                break;
+            }
+            case Command::Look:
                 describeLocation();
-            else if (command == "fight")
+                break;
+            case Command::Fight:
                 fight();
-            else if (command == "flee")
+                break;
+            case Command::Flee:
                 flee();
-            else if (command == "loot")
-                loot();
-            else if (command == "stats")
+                break;
+            case Command::Loot:
+                if (command.argument.empty()) {
+                    loot();
+                } else {
+                    lootItem(command.argument);
+                }
+                break;
+            case Command::Stats:
                 showStats();
-            else if (command == "inv")
+                break;
+            case Command::Inventory:
                 showInventory();
+                break;
+            case Command::Quests:
+                if constexpr (WITH_QUESTS) {
 #ifdef SESSION_11_AVAILABLE
-            else if (command == "quests")
-                showQuests();
+                    showQuests();
+#endif
+                } else {
+                    out_ << "Unknown command. Type 'look' for help.\n";
+                }
+                break;
+            case Command::Perf:
+#if CPP_QUEST_METRICS
+                metrics_.worldChunks = world_.chunkStats();
+                metrics_.printTable(out_);
+#else
+                out_ << "Metrics are disabled in this build (CPP_QUEST_METRICS=OFF).\n";
 #endif
-            else if (command == "save")
+                break;
+            case Command::Save:
                 saveGame();
-            else if (command == "load")
+                break;
+            case Command::Load:
                 loadGame();
-            else if (command == "quit")
-                running_ = false;
-            else
-                std::cout << "Unknown command. Type 'look' for help.\n";
-
-            if (bossDefeated_) {
-                std::cout << "\n";
-                std::cout << "╔════════════════════════════════════════╗\n";
-                std::cout << "║          VICTORY!                      ║\n";
-                std::cout << "╚════════════════════════════════════════╝\n";
-                std::cout << "You have defeated the Ancient Dragon!\n";
-                std::cout << "The dungeon is cleared. You are a true hero!\n\n";
-                std::cout << "Final Stats:\n";
-                showStats();
+                break;
+            case Command::Export:
+                exportGame();
+                break;
+            case Command::Import:
+                importGame();
+                break;
+            case Command::Goto:
+                travel(command.argument, true);
+                break;
+            case Command::Path:
+                travel(command.argument, false);
+                break;
+            case Command::Quit:
+                outcome_ = GameOutcome::Quit;
                 running_ = false;
-            }
+                break;
+            case Command::Unknown:
+                out_ << "Unknown command. Type 'look' for help.\n";
+                break;
+        }
+    }
 
-            if (playerHealth_ <= 0) {
-                std::cout << "\n";
-                std::cout << "╔════════════════════════════════════════╗\n";
-                std::cout << "║          GAME OVER                     ║\n";
-                std::cout << "╚════════════════════════════════════════╝\n";
-                std::cout << "You have fallen in the dungeon...\n";
-                std::cout << "Better luck next time!\n\n";
-                running_ = false;
+    void checkGameOver() {
+        if (bossDefeated_) {
+            out_ << "\n";
+            out_ << "╔════════════════════════════════════════╗\n";
+            out_ << "║          VICTORY!                      ║\n";
+            out_ << "╚════════════════════════════════════════╝\n";
+            out_ << "You have defeated the Ancient Dragon!\n";
+            out_ << "The dungeon is cleared. You are a true hero!\n\n";
+            out_ << "Final Stats:\n";
+            showStats();
+            outcome_ = GameOutcome::Victory;
+            running_ = false;
+        }
+
+        if (playerHealth_ <= 0) {
+            out_ << "\n";
+            out_ << "╔════════════════════════════════════════╗\n";
+            out_ << "║          GAME OVER                     ║\n";
+            out_ << "╚════════════════════════════════════════╝\n";
+            out_ << "You have fallen in the dungeon...\n";
+            out_ << "Better luck next time!\n\n";
+            outcome_ = GameOutcome::Death;
+            running_ = false;
+        }
+    }
+
+    // Interactive games are unpredictable unless seeded. Opening the random device costs
+    // more than the rest of construction, and batch and hosted sessions are always seeded,
+    // so it waits for the first draw.
+    static uint64_t randomSeed() {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) ^ device();
+    }
+
+    GameRng& rng() {
+        if (!rngSeeded_) {
+            seedRandom(randomSeed());
+        }
+        return rng_;
+    }
+
+    static constexpr EnemyStore::EnemyId NO_ENEMY = ~EnemyStore::EnemyId{0};
+
+    // First enemy still alive in the room, or NO_ENEMY
+    EnemyStore::EnemyId livingEnemy(int room) const {
+        EnemyStore::EnemyId begin = world_.enemyBegin(room);
+        EnemyStore::EnemyId end = begin + static_cast<EnemyStore::EnemyId>(world_.enemyCount(room));
+        for (EnemyStore::EnemyId id = begin; id < end; ++id) {
+            if (enemies_.alive(id)) {
+                return id;
             }
         }
+        return NO_ENEMY;
     }
 
-    void shutdown() {
-        std::cout << "\nThanks for playing C++ Quest!\n";
-        std::cout << "Keep learning and building! 🚀\n\n";
+#ifdef SESSION_08_AVAILABLE
+    // Session 8's classes name the enemy types; asked when describing, never in combat
+    static const std::string& enemyType(bool caster) {
+        static const std::string mage = Mage("", 1, 0, 0).getType();
+        static const std::string warrior = Warrior("", 1, 0, 0).getType();
+        return caster ? mage : warrior;
     }
+#endif
+
+    struct QuestDefinition {
+        const char* id;
+        const char* name;
+        GameEvent event;
+        std::string_view subject;  // the enemy, item or room name the event carries
+    };
+
+    static constexpr QuestDefinition QUESTS[] = {
+        {"goblin", "Defeat the Goblin Scout", GameEvent::EnemyDefeated, "Goblin Scout"},
+        {"skeleton", "Defeat the Skeleton Warrior", GameEvent::EnemyDefeated, "Skeleton Warrior"},
+        {"treasure", "Find the Magic Amulet", GameEvent::ItemLooted, "Magic Amulet"},
+        {"dragon", "Slay the Ancient Dragon", GameEvent::EnemyDefeated, "Ancient Dragon"},
+    };
 
-   private:
-#ifdef SESSION_11_AVAILABLE
     void initializeQuests() {
-        questManager_->addQuest({"goblin", "Defeat the Goblin Scout", false});
-        questManager_->addQuest({"skeleton", "Defeat the Skeleton Warrior", false});
-        questManager_->addQuest({"treasure", "Find the Magic Amulet", false});
-        questManager_->addQuest({"dragon", "Slay the Ancient Dragon", false});
-    }
-
-    void checkQuestCompletion(const std::string& questId) {
-        if (!questManager_->isCompleted(questId)) {
-            questManager_->completeQuest(questId);
-            std::cout << "\n🎯 Quest Completed: ";
-            auto quests = questManager_->getCompletedQuests();
-            for (const auto& q : quests) {
-                if (q.id == questId) {
-                    std::cout << q.name << "\n";
-                    break;
+        quests_.clear();
+        if constexpr (WITH_QUESTS) {
+            for (const auto& quest : QUESTS) {
+                quests_.add(quest.event, QuestBus::NO_SUBJECT);
+            }
+        }
+#ifdef SESSION_11_AVAILABLE
+        questManager_.reset();
+#endif
+        bindQuests();
+    }
+
+#ifdef SESSION_11_AVAILABLE
+    // Built from the bus when the log is first shown; publish() keeps it current after that
+    QuestManager& questLog() {
+        if (!questManager_) {
+            questManager_ = std::make_unique<QuestManager>();
+            for (QuestBus::QuestId quest = 0; quest < std::size(QUESTS); ++quest) {
+                questManager_->addQuest({QUESTS[quest].id, QUESTS[quest].name, false});
+                if (quests_.completed(quest)) {
+                    questManager_->completeQuest(QUESTS[quest].id);
                 }
             }
         }
+        return *questManager_;
     }
 #endif
 
-    void displayAvailableSessions() {
-        auto sessions = SessionConfig::getAvailableSessions();
-        std::cout << "📚 Sessions integrated: ";
-
-        if (sessions.empty()) {
-            std::cout << "None (using fallback code)\n";
-        } else {
-            for (size_t i = 0; i < sessions.size(); ++i) {
-                std::cout << sessions[i];
-                if (i < sessions.size() - 1)
-                    std::cout << ", ";
+    uint32_t questSubject(const QuestDefinition& quest) const {
+        switch (quest.event) {
+            case GameEvent::EnemyDefeated:
+                return enemies_.findName(quest.subject);
+            case GameEvent::ItemLooted: {
+                ItemId item = findItem(quest.subject);
+                return item == NO_ITEM ? QuestBus::NO_SUBJECT : item;
             }
-            std::cout << "\n";
+            case GameEvent::RoomEntered:
+                return world_.findName(quest.subject);
         }
+        return QuestBus::NO_SUBJECT;
+    }
 
-#ifdef SESSION_02_AVAILABLE
-        std::cout << "   ✅ Session 2: Inventory system (dynamic memory)\n";
-#endif
-#ifdef SESSION_03_AVAILABLE
-        std::cout << "   ✅ Session 3: Save/Load system (file I/O)\n";
-#endif
-#ifdef SESSION_04_AVAILABLE
-        std::cout << "   ✅ Session 4: Weapon system (smart pointers)\n";
-#endif
-#ifdef SESSION_05_AVAILABLE
-        std::cout << "   ✅ Session 5: Spell system (classes)\n";
-#endif
-#ifdef SESSION_08_AVAILABLE
-        std::cout << "   ✅ Session 8: Combat system (polymorphism)\n";
-#endif
+    void worldReplaced() {
+        routes_.invalidate();
+        streamReplacedWorld();
+        bindQuests();
+    }
+
+    // A new world starts in memory; a streamed game moves it out again. If the file can't be
+    // rewritten the world simply stays in memory.
+    void streamReplacedWorld() {
+        if (!streamPath_.empty() && !world_.streamed()) {
+            world_.streamTo(streamPath_, residentChunks_);
+        }
+    }
+
+    // Enemy and room subjects are name ids, which differ from world to world
+    void bindQuests() {
+        for (QuestBus::QuestId quest = 0; quest < quests_.size(); ++quest) {
+            quests_.subscribe(quest, questSubject(QUESTS[quest]));
+        }
+    }
+
+    void publish([[maybe_unused]] GameEvent event, [[maybe_unused]] uint32_t subject) {
+        if constexpr (WITH_QUESTS) {
+            quests_.publish(event, subject, [this](QuestBus::QuestId quest) {
 #ifdef SESSION_11_AVAILABLE
-        std::cout << "   ✅ Session 11: Quest system (STL containers)\n";
+                if (questManager_) {
+                    questManager_->completeQuest(QUESTS[quest].id);
+                }
 #endif
-        std::cout << "\n";
+                out_ << "\n🎯 Quest Completed: " << QUESTS[quest].name << "\n";
+            });
+        }
     }
 
-    void describeLocation() {
-        Location& loc = *dungeon_[currentLocation_];
-        currentLocationName_ = loc.name;
+    // Sessions whose module this game leaves out aren't listed
+    void displayAvailableSessions() {
+        out_ << "📚 Sessions integrated: ";
 
-        std::cout << "\n═══════════════════════════════════\n";
-        std::cout << loc.name << "\n";
-        std::cout << "═══════════════════════════════════\n";
-        std::cout << loc.description << "\n";
+        const char* separator = "";
+        for (int session : SessionConfig::getAvailableSessions()) {
+            if (sessionSelected(Modules, session)) {
+                out_ << separator << session;
+                separator = ", ";
+            }
+        }
+        out_ << (*separator ? "\n" : "None (using fallback code)\n");
 
-        if (loc.enemy && loc.enemy->isAlive()) {
-            std::cout << "\n⚠️  " << loc.enemy->getName() << " blocks your path!\n";
+        for (const ModuleInfo& module : SESSION_MODULES) {
+            if (Modules.has(module.module)) {
+                out_ << "   ✅ Session " << module.session << ": " << module.description << "\n";
+            }
+        }
+        out_ << "\n";
+    }
+
+    void describeLocation() {
+        int room = currentLocation_;
+        currentLocationName_ = world_.name(room);
+
+        out_ << "\n═══════════════════════════════════\n";
+        out_ << world_.name(room) << "\n";
+        out_ << "═══════════════════════════════════\n";
+        out_ << world_.description(room) << "\n";
+
+        EnemyStore::EnemyId firstEnemy = world_.enemyBegin(room);
+        for (size_t i = 0; i < world_.enemyCount(room); ++i) {
+            EnemyStore::EnemyId enemy = firstEnemy + static_cast<EnemyStore::EnemyId>(i);
+            if (!enemies_.alive(enemy)) {
+                continue;
+            }
+            out_ << "\n⚠️  " << enemies_.name(enemy) << " blocks your path!\n";
+            if constexpr (WITH_COMBAT) {
 #ifdef SESSION_08_AVAILABLE
-            std::cout << "   Type: " << loc.enemy->getType() << "\n";
+                out_ << "   Type: " << enemyType(enemies_.is(enemy, EnemyStore::CASTER)) << "\n";
 #endif
-            std::cout << "   HP: " << loc.enemy->getHealth() << "\n";
+            }
+            out_ << "   HP: " << enemies_.health(enemy) << "\n";
         }
 
-        if (!loc.treasureNames.empty()) {
-            std::cout << "\n✨ You see treasure here:\n";
-            for (size_t i = 0; i < loc.treasureNames.size(); ++i) {
-                std::cout << "   - " << loc.treasureNames[i];
-                std::cout << " (" << loc.treasureValues[i] << " gold)\n";
+        size_t treasure = world_.treasureCount(room);
+        if (treasure > 0) {
+            out_ << "\n✨ You see treasure here:\n";
+            for (size_t i = 0; i < treasure; ++i) {
+                out_ << "   - " << world_.treasureName(room, i);
+                out_ << " (" << world_.treasureValue(room, i) << " gold)\n";
             }
         }
 
-        std::cout << "\nExits: ";
-        for (const auto& exit : loc.exits) {
-            switch (exit.first) {
+        out_ << "\nExits: ";
+        const auto& exits = world_.exits(room);
+        for (int slot = 0; slot < WorldStore::EXIT_SLOTS; ++slot) {
+            if (exits[slot] == WorldStore::NO_ROOM) {
+                continue;
+            }
+            switch (WorldStore::SLOT_DIRECTIONS[slot]) {
                 case 'n':
-                    std::cout << "north ";
+                    out_ << "north ";
                     break;
                 case 's':
-                    std::cout << "south ";
+                    out_ << "south ";
                     break;
                 case 'e':
-                    std::cout << "east ";
+                    out_ << "east ";
                     break;
                 case 'w':
-                    std::cout << "west ";
+                    out_ << "west ";
                     break;
             }
         }
-        std::cout << "\n";
+        out_ << "\n";
 
-        loc.visited = true;
+        markVisited(room);
     }
 
-    void move(char direction) {
-        Location& loc = *dungeon_[currentLocation_];
+    void markVisited(int room) {
+        GAME_METRIC(metrics_.roomsDiscovered += world_.visited(room) ? 0 : 1);
+        world_.markVisited(room);
+    }
 
-        if (loc.enemy && loc.enemy->isAlive()) {
-            std::cout << "You cannot leave while " << loc.enemy->getName()
-                      << " blocks your path!\n";
-            std::cout << "Fight or flee!\n";
+    static const char* directionName(char direction) {
+        switch (direction) {
+            case 'n':
+                return "north";
+            case 's':
+                return "south";
+            case 'e':
+                return "east";
+            default:
+                return "west";
+        }
+    }
+
+    // Room a goto/path argument names: a room number, or the closest room with that name.
+    // Leaves the way there in route_; NO_ROOM (after saying why) if there is none.
+    WorldStore::RoomId findRoute(std::string_view where) {
+        bool number = !where.empty() && where.find_first_not_of("0123456789") == where.npos;
+        if (number) {
+            size_t room = std::strtoul(std::string(where).c_str(), nullptr, 10);
+            if (where.size() > 9 || room >= world_.roomCount()) {
+                out_ << "There is no room " << where << ".\n";
+                return WorldStore::NO_ROOM;
+            }
+            auto target = static_cast<WorldStore::RoomId>(room);
+            if (routes_.route(world_, currentLocation_, target, route_)) {
+                return target;
+            }
+        } else {
+            uint32_t nameId = world_.findName(where);
+            WorldStore::RoomId target = nameId == StringTable::NONE
+                                            ? WorldStore::NO_ROOM
+                                            : routes_.routeToName(world_, currentLocation_,
+                                                                  nameId, route_);
+            if (target != WorldStore::NO_ROOM) {
+                return target;
+            }
+        }
+        out_ << "You know of no way to " << where << ".\n";
+        return WorldStore::NO_ROOM;
+    }
+
+    // goto (walk) and path (only show the way)
+    void travel(std::string_view where, bool walk) {
+        if (where.empty()) {
+            out_ << "Which room? Try '" << (walk ? "goto" : "path") << " Grand Hall'.\n";
+            return;
+        }
+        WorldStore::RoomId target = findRoute(where);
+        if (target == WorldStore::NO_ROOM) {
+            return;
+        }
+        if (route_.empty()) {
+            out_ << "You are already in " << world_.name(target) << ".\n";
             return;
         }
 
-        auto it = loc.exits.find(direction);
-        if (it == loc.exits.end()) {
-            std::cout << "You cannot go that way.\n";
+        if (!walk) {
+            out_ << "🧭 " << world_.name(target) << " (room " << target << ") is "
+                 << route_.size() << (route_.size() == 1 ? " room" : " rooms") << " away: ";
+            printDirections(currentLocation_);
             return;
         }
 
-        currentLocation_ = it->second;
-        std::cout << "You move ";
+        EnemyStore::EnemyId enemy = livingEnemy(currentLocation_);
+        if (enemy != NO_ENEMY) {
+            out_ << "You cannot leave while " << enemies_.name(enemy) << " blocks your path!\n";
+            out_ << "Fight or flee!\n";
+            return;
+        }
+
+        // Walk the route, stopping where an enemy bars the way
+        size_t steps = 0;
+        for (WorldStore::RoomId room : route_) {
+            currentLocation_ = room;
+            ++steps;
+            GAME_METRIC(++metrics_.roomsEntered);
+            publish(GameEvent::RoomEntered, world_.nameId(room));
+            if (livingEnemy(room) != NO_ENEMY) {
+                break;
+            }
+            if (room != target) {
+                markVisited(room);
+            }
+        }
+        out_ << "You walk " << steps << (steps == 1 ? " room" : " rooms")
+             << (currentLocation_ == target ? ".\n" : " and are stopped.\n");
+        describeLocation();
+    }
+
+    // Directions along route_ from `from`, with repeats folded ("north x3, east")
+    void printDirections(WorldStore::RoomId from) {
+        size_t i = 0;
+        while (i < route_.size()) {
+            char direction = stepDirection(i == 0 ? from : route_[i - 1], route_[i]);
+            size_t repeat = 1;
+            while (i + repeat < route_.size() &&
+                   stepDirection(route_[i + repeat - 1], route_[i + repeat]) == direction) {
+                ++repeat;
+            }
+            out_ << (i == 0 ? "" : ", ") << directionName(direction);
+            if (repeat > 1) {
+                out_ << " x" << repeat;
+            }
+            i += repeat;
+        }
+        out_ << "\n";
+    }
+
+    char stepDirection(WorldStore::RoomId from, WorldStore::RoomId to) const {
+        const auto& exits = world_.exits(from);
+        for (int slot = 0; slot < WorldStore::EXIT_SLOTS; ++slot) {
+            if (exits[slot] == to) {
+                return WorldStore::SLOT_DIRECTIONS[slot];
+            }
+        }
+        return '\0';
+    }
+
+    void move(char direction) {
+        EnemyStore::EnemyId enemy = livingEnemy(currentLocation_);
+        if (enemy != NO_ENEMY) {
+            out_ << "You cannot leave while " << enemies_.name(enemy) << " blocks your path!\n";
+            out_ << "Fight or flee!\n";
+            return;
+        }
+
+        int target = world_.exit(currentLocation_, direction);
+        if (target == WorldStore::NO_ROOM) {
+            out_ << "You cannot go that way.\n";
+            return;
+        }
+
+        currentLocation_ = target;
+        world_.prefetchExits(target);
+        GAME_METRIC(++metrics_.roomsEntered);
+        publish(GameEvent::RoomEntered, world_.nameId(target));
+        out_ << "You move ";
         switch (direction) {
             case 'n':
-                std::cout << "north";
+                out_ << "north";
                 break;
             case 's':
-                std::cout << "south";
+                out_ << "south";
                 break;
             case 'e':
-                std::cout << "east";
+                out_ << "east";
                 break;
             case 'w':
-                std::cout << "west";
+                out_ << "west";
                 break;
         }
-        std::cout << "...\n";
+        out_ << "...\n";
 
         describeLocation();
     }
 
     void fight() {
-        Location& loc = *dungeon_[currentLocation_];
-
-        if (!loc.enemy || !loc.enemy->isAlive()) {
-            std::cout << "There is nothing to fight here.\n";
+        EnemyStore::EnemyId enemy = livingEnemy(currentLocation_);
+        if (enemy == NO_ENEMY) {
+            out_ << "There is nothing to fight here.\n";
             return;
         }
+        GAME_METRIC(++metrics_.fights);
 
-#ifdef SESSION_08_AVAILABLE
-        Entity* enemy = loc.enemy.get();
-
-        std::cout << "\n⚔️  COMBAT!\n";
-        std::cout << "You vs " << enemy->getName() << " (" << enemy->getType() << ")\n\n";
-
-        while (enemy->isAlive() && playerHealth_ > 0) {
-            // Player attacks
-            int totalAttack = playerAttack_;
-#    ifdef SESSION_04_AVAILABLE
+        // Everything the rounds need is read up front; the loop itself only does arithmetic
+        const std::string& name = enemies_.name(enemy);
+        int totalAttack = playerAttack_;
+        if constexpr (WITH_WEAPONS) {
+#ifdef SESSION_04_AVAILABLE
             if (equippedWeapon_) {
                 totalAttack += equippedWeapon_->getDamage();
             }
-#    endif
-            int damage = totalAttack + (rand() % 5);
-            enemy->takeDamage(damage);
-
-            std::cout << "You attack for " << damage << " damage!\n";
-            std::cout << enemy->getName() << " HP: " << enemy->getHealth() << "\n";
-
-            if (!enemy->isAlive()) {
-                std::cout << "\n🎉 Victory! " << enemy->getName() << " defeated!\n";
+#endif
+        }
+        int enemyBase =
+            COMBAT_RULES.enemyUsesAttack ? enemies_.attack(enemy) : COMBAT_RULES.fixedEnemyBase;
 
-#    ifdef SESSION_11_AVAILABLE
-                // Check quest completion
-                if (enemy->getName() == "Goblin Scout") {
-                    checkQuestCompletion("goblin");
-                } else if (enemy->getName() == "Skeleton Warrior") {
-                    checkQuestCompletion("skeleton");
-                } else if (enemy->getName() == "Ancient Dragon") {
-                    checkQuestCompletion("dragon");
-                }
-#    endif
+        out_ << "\n⚔️  COMBAT!\n";
+        if constexpr (WITH_COMBAT) {
+#ifdef SESSION_08_AVAILABLE
+            out_ << "You vs " << name << " ("
+                 << enemyType(enemies_.is(enemy, EnemyStore::CASTER)) << ")\n\n";
+#endif
+        } else {
+            out_ << "You vs " << name << "\n\n";
+        }
 
-                if (enemy->getType() == "Mage" && enemy->getName() == "Ancient Dragon") {
-                    bossDefeated_ = true;
-                }
+        while (playerHealth_ > 0) {
+            GAME_METRIC(++metrics_.fightRounds);
+            int damage = totalAttack + rng().below(COMBAT_RULES.playerRoll);
+            int enemyHealth = enemies_.damage(enemy, damage);
 
-                if (!loc.treasureNames.empty()) {
-                    std::cout << "\n💎 " << enemy->getName() << " dropped treasure!\n";
-                }
-                break;
+            out_ << "You attack for " << damage << " damage!\n";
+            if constexpr (WITH_COMBAT) {
+                out_ << name << " HP: " << enemyHealth << "\n";
+            } else {
+                out_ << name << " HP: " << enemyHealth << "/" << enemies_.maxHealth(enemy) << "\n";
             }
-
-            // Enemy attacks using polymorphism - just for visual effect
-            std::cout << "\n";
-            // Create a dummy player entity for the attack visual
-            // The actual damage is calculated below
-            std::cout << enemy->getName() << " attacks!\n";
-
-            // Calculate actual damage
-            int enemyDamage = 10 + (rand() % 5);
-            playerHealth_ -= enemyDamage;
-            if (playerHealth_ < 0)
-                playerHealth_ = 0;
-
-            std::cout << "You take " << enemyDamage << " damage!\n";
-            std::cout << "Your HP: " << playerHealth_ << "/" << playerMaxHealth_ << "\n\n";
-
-            if (playerHealth_ <= 0) {
+            if (enemyHealth == 0) {
+                defeatEnemy(enemy);
                 return;
             }
-        }
-#else
-        // Fallback combat
-        Enemy& enemy = *loc.enemy;
-
-        std::cout << "\n⚔️  COMBAT!\n";
-        std::cout << "You vs " << enemy.name << "\n\n";
 
-        while (enemy.isAlive() && playerHealth_ > 0) {
-            int totalAttack = playerAttack_;
-#    ifdef SESSION_04_AVAILABLE
-            if (equippedWeapon_) {
-                totalAttack += equippedWeapon_->getDamage();
+            int enemyDamage = enemyBase + rng().below(COMBAT_RULES.enemyRoll);
+            playerHealth_ = std::max(0, playerHealth_ - enemyDamage);
+            if constexpr (WITH_COMBAT) {
+                out_ << "\n" << name << " attacks!\n";
+                out_ << "You take " << enemyDamage << " damage!\n";
+            } else {
+                out_ << name << " attacks for " << enemyDamage << " damage!\n";
             }
-#    endif
-            int damage = totalAttack + (rand() % 5);
-            enemy.health -= damage;
-            if (enemy.health < 0)
-                enemy.health = 0;
-
-            std::cout << "You attack for " << damage << " damage!\n";
-            std::cout << enemy.name << " HP: " << enemy.health << "/" << enemy.maxHealth << "\n";
-
-            if (!enemy.isAlive()) {
-                std::cout << "\n🎉 Victory! " << enemy.name << " defeated!\n";
-
-                if (enemy.isBoss) {
-                    bossDefeated_ = true;
-                }
+            out_ << "Your HP: " << playerHealth_ << "/" << playerMaxHealth_ << "\n\n";
+        }
+    }
 
-                if (!loc.treasureNames.empty()) {
-                    std::cout << "\n💎 " << enemy.name << " dropped treasure!\n";
-                }
-                break;
-            }
+    void defeatEnemy(EnemyStore::EnemyId enemy) {
+        const std::string& name = enemies_.name(enemy);
+        out_ << "\n🎉 Victory! " << name << " defeated!\n";
+        GAME_METRIC(++metrics_.fightsWon);
 
-            int enemyDamage = enemy.attack + (rand() % 3);
-            playerHealth_ -= enemyDamage;
-            if (playerHealth_ < 0)
-                playerHealth_ = 0;
+        publish(GameEvent::EnemyDefeated, enemies_.nameId(enemy));
 
-            std::cout << enemy.name << " attacks for " << enemyDamage << " damage!\n";
-            std::cout << "Your HP: " << playerHealth_ << "/" << playerMaxHealth_ << "\n\n";
+        if (enemies_.is(enemy, EnemyStore::BOSS)) {
+            bossDefeated_ = true;
+        }
 
-            if (playerHealth_ <= 0) {
-                return;
-            }
+        if (world_.treasureCount(currentLocation_) > 0) {
+            out_ << "\n💎 " << name << " dropped treasure!\n";
         }
-#endif
     }
 
     void flee() {
-        Location& loc = *dungeon_[currentLocation_];
+        EnemyStore::EnemyId enemy = livingEnemy(currentLocation_);
 
-        if (!loc.enemy || !loc.enemy->isAlive()) {
-            std::cout << "There is nothing to flee from.\n";
+        if (enemy == NO_ENEMY) {
+            out_ << "There is nothing to flee from.\n";
             return;
         }
 
-        std::cout << "You flee from " << loc.enemy->getName() << "!\n";
+        out_ << "You flee from " << enemies_.name(enemy) << "!\n";
 
         int damage = 5;
         playerHealth_ -= damage;
         if (playerHealth_ < 0)
             playerHealth_ = 0;
 
-        std::cout << loc.enemy->getName() << " strikes you as you run! (-" << damage << " HP)\n";
-        std::cout << "Your HP: " << playerHealth_ << "/" << playerMaxHealth_ << "\n";
+        out_ << enemies_.name(enemy) << " strikes you as you run! (-" << damage << " HP)\n";
+        out_ << "Your HP: " << playerHealth_ << "/" << playerMaxHealth_ << "\n";
 
         currentLocation_ = 0;
-        std::cout << "You retreat to the entrance.\n";
+        GAME_METRIC(++metrics_.roomsEntered);
+        out_ << "You retreat to the entrance.\n";
         describeLocation();
     }
 
     void loot() {
-        Location& loc = *dungeon_[currentLocation_];
+        int room = currentLocation_;
+        size_t treasure = world_.treasureCount(room);
 
-        if (loc.treasureNames.empty()) {
-            std::cout << "There is no treasure here.\n";
+        if (treasure == 0) {
+            out_ << "There is no treasure here.\n";
             return;
         }
 
-        std::cout << "\n💰 You collect:\n";
-        for (size_t i = 0; i < loc.treasureNames.size(); ++i) {
-            const std::string& name = loc.treasureNames[i];
-            int value = loc.treasureValues[i];
+        out_ << "\n💰 You collect:\n";
+        for (size_t i = 0; i < treasure; ++i) {
+            takeTreasure(room, i);
+        }
+
+        world_.clearTreasure(room);
+    }
+
+    // loot <number>: take only the number-th item listed by describeLocation()
+    // item is the number the player typed, counting from 1
+    void lootItem(std::string_view item) {
+        int room = currentLocation_;
+        size_t treasure = world_.treasureCount(room);
+
+        if (treasure == 0) {
+            out_ << "There is no treasure here.\n";
+            return;
+        }
+        // Stays 0, which no item has, for a negative or overlong number
+        size_t number = 0;
+        std::from_chars(item.data(), item.data() + item.size(), number);
+        if (number == 0 || number > treasure) {
+            out_ << "There is no item " << item << " here.\n";
+            return;
+        }
+
+        out_ << "\n💰 You collect:\n";
+        takeTreasure(room, number - 1);
+        world_.removeTreasure(room, number - 1);
+    }
 
 #ifdef SESSION_02_AVAILABLE
-            inventory_->addItem(name, value);
-#else
-            inventory_.push_back(Item(name, value));
-            std::cout << "   - " << name << " (" << value << " gold)\n";
+    // Nothing is carried before the first loot or load (which builds its own), so the
+    // mirror starts out empty
+    Inventory& inventory() {
+        if (!inventory_) {
+            inventory_ = std::make_unique<Inventory>(20);
+        }
+        return *inventory_;
+    }
 #endif
 
-            playerGold_ += value;
+    void takeTreasure(int room, size_t i) {
+        const ItemDefinition& item = itemDefinition(world_.treasureItem(room, i));
+        items_.add(world_.treasureItem(room, i));
 
-#ifdef SESSION_11_AVAILABLE
-            // Check quest completion for Magic Amulet
-            if (name == "Magic Amulet") {
-                checkQuestCompletion("treasure");
-            }
+        if constexpr (WITH_INVENTORY) {
+#ifdef SESSION_02_AVAILABLE
+            inventory().addItem(std::string(item.name), item.value);
 #endif
+        } else {
+            out_ << "   - " << item.name << " (" << item.value << " gold)\n";
+        }
 
-            // Check for weapons
+        playerGold_ += item.value;
+
+        publish(GameEvent::ItemLooted, world_.treasureItem(room, i));
+
+        if constexpr (WITH_WEAPONS) {
 #ifdef SESSION_04_AVAILABLE
-            if (name.find("Sword") != std::string::npos ||
-                name.find("Dagger") != std::string::npos) {
-                int weaponDamage = value / 10;
-                equippedWeapon_ = std::make_unique<Weapon>(name, weaponDamage);
-                std::cout << "   ⚔️  Equipped " << name << " (+" << weaponDamage << " damage)\n";
+            if (item.weaponDamage > 0) {
+                equippedWeapon_ =
+                    std::make_unique<Weapon>(std::string(item.name), item.weaponDamage);
+                equippedWeaponName_ = item.name;
+                out_ << "   ⚔️  Equipped " << item.name << " (+" << item.weaponDamage
+                     << " damage)\n";
             }
 #endif
         }
-
-        loc.treasureNames.clear();
-        loc.treasureValues.clear();
     }
 
     void showStats() {
-        std::cout << "\n╔════════════════════════════════════════╗\n";
-        std::cout << "║          CHARACTER STATS               ║\n";
-        std::cout << "╚════════════════════════════════════════╝\n";
-        std::cout << "Name:     " << playerName_ << "\n";
-        std::cout << "Level:    " << playerLevel_ << "\n";
-        std::cout << "Health:   " << playerHealth_ << "/" << playerMaxHealth_ << "\n";
-        std::cout << "Attack:   " << playerAttack_;
-
+        out_ << "\n╔════════════════════════════════════════╗\n";
+        out_ << "║          CHARACTER STATS               ║\n";
+        out_ << "╚════════════════════════════════════════╝\n";
+        out_ << "Name:     " << playerName_ << "\n";
+        out_ << "Level:    " << playerLevel_ << "\n";
+        out_ << "Health:   " << playerHealth_ << "/" << playerMaxHealth_ << "\n";
+        out_ << "Attack:   " << playerAttack_;
+
+        if constexpr (WITH_WEAPONS) {
 #ifdef SESSION_04_AVAILABLE
-        if (equippedWeapon_) {
-            std::cout << " + " << equippedWeapon_->getDamage() << " (weapon)";
-        }
+            if (equippedWeapon_) {
+                out_ << " + " << equippedWeapon_->getDamage() << " (weapon)";
+            }
 #endif
-        std::cout << "\n";
-        std::cout << "Gold:     " << playerGold_ << "\n";
-        std::cout << "Location: " << currentLocationName_ << "\n";
-
-        int barWidth = 20;
-        int filled = playerMaxHealth_ > 0 ? (playerHealth_ * barWidth) / playerMaxHealth_ : 0;
-        std::cout << "HP:       [";
-        for (int i = 0; i < barWidth; ++i) {
-            std::cout << (i < filled ? "█" : "░");
         }
-        std::cout << "]\n";
+        out_ << "\n";
+        out_ << "Gold:     " << playerGold_ << "\n";
+        out_ << "Location: " << currentLocationName_ << "\n";
+
+        constexpr int HP_BAR_WIDTH = 20;
+        char bar[bars::barBytes(HP_BAR_WIDTH)];
+        char* end = bars::renderBar(bar, playerHealth_, playerMaxHealth_, HP_BAR_WIDTH);
+        out_ << "HP:       " << std::string_view(bar, static_cast<size_t>(end - bar)) << "\n";
     }
 
     void showInventory() {
+        if constexpr (WITH_INVENTORY) {
 #ifdef SESSION_02_AVAILABLE
-        inventory_->display();
-#else
-        std::cout << "\n🎒 Inventory (" << inventory_.size() << " items):\n";
-        if (inventory_.empty()) {
-            std::cout << "   (empty)\n";
+            // Inventory prints to std::cout itself; keep it in order with our frame
+            out_.flush();
+            inventory().display();
+            std::cout.flush();
+#endif
+            return;
+        }
+        out_ << "\n🎒 Inventory (" << items_.size() << " items):\n";
+        if (items_.empty()) {
+            out_ << "   (empty)\n";
         } else {
-            for (size_t i = 0; i < inventory_.size(); ++i) {
-                std::cout << "   " << (i + 1) << ". " << inventory_[i].name << " ("
-                          << inventory_[i].value << " gold)\n";
+            size_t number = 0;
+            for (ItemId id : items_) {
+                const ItemDefinition& item = itemDefinition(id);
+                out_ << "   " << ++number << ". " << item.name << " (" << item.value << " gold)\n";
             }
+            out_ << "   Total: " << items_.gold() << " gold, weight " << items_.weight() << "\n";
         }
-#endif
     }
 
 #ifdef SESSION_11_AVAILABLE
     void showQuests() {
-        std::cout << "\n📜 Quest Log:\n";
-        std::cout << "═══════════════════════════════════\n";
+        out_ << "\n📜 Quest Log:\n";
+        out_ << "═══════════════════════════════════\n";
 
-        auto active = questManager_->getActiveQuests();
-        auto completed = questManager_->getCompletedQuests();
+        QuestManager& log = questLog();
+        auto active = log.getActiveQuests();
+        auto completed = log.getCompletedQuests();
 
         if (!active.empty()) {
-            std::cout << "\n🔸 Active Quests:\n";
+            out_ << "\n🔸 Active Quests:\n";
             for (const auto& quest : active) {
-                std::cout << "   [ ] " << quest.name << "\n";
+                out_ << "   [ ] " << quest.name << "\n";
             }
         }
 
         if (!completed.empty()) {
-            std::cout << "\n✅ Completed Quests:\n";
+            out_ << "\n✅ Completed Quests:\n";
             for (const auto& quest : completed) {
-                std::cout << "   [✓] " << quest.name << "\n";
+                out_ << "   [✓] " << quest.name << "\n";
             }
         }
 
-        std::cout << "\nProgress: " << questManager_->getCompletedCount() << "/"
-                  << questManager_->getQuestCount() << " quests completed\n";
+        out_ << "\nProgress: " << log.getCompletedCount() << "/" << log.getQuestCount()
+             << " quests completed\n";
     }
 #endif
 
-    void saveGame() {
-        std::cout << "💾 Saving game...\n";
+    // Snapshot layout: player, inventory, weapon, quest progress, world, enemies.
+    // readSnapshot() parses into temporaries and only commits when all of it is valid.
+    void writeSnapshot(SnapshotWriter& out) const {
+        out.putString(playerName_);
+        out.put<int32_t>(playerHealth_);
+        out.put<int32_t>(playerMaxHealth_);
+        out.put<int32_t>(playerAttack_);
+        out.put<int32_t>(playerGold_);
+        out.put<int32_t>(playerLevel_);
+        out.put<int32_t>(currentLocation_);
+        out.put<uint8_t>(bossDefeated_);
+
+        items_.writeSnapshot(out);
+
+        if constexpr (WITH_WEAPONS) {
+#ifdef SESSION_04_AVAILABLE
+            out.put<uint8_t>(equippedWeapon_ != nullptr);
+            out.putString(equippedWeaponName_);
+            out.put<int32_t>(equippedWeapon_ ? equippedWeapon_->getDamage() : 0);
+#endif
+        } else {
+            out.put<uint8_t>(0);
+            out.putString("");
+            out.put<int32_t>(0);
+        }
 
-#ifdef SESSION_03_AVAILABLE
-        GameState state(playerName_, "Adventurer", playerLevel_, playerGold_, currentLocationName_);
+        out.putColumn(quests_.progressColumn());
+
+        world_.writeSnapshot(out);
+
+        enemies_.writeSnapshot(out);
+    }
 
-        // Add inventory items
-#    ifdef SESSION_02_AVAILABLE
-        for (int i = 0; i < inventory_->getCount(); ++i) {
-            // Note: Can't access items directly, so we save count only
-            state.addItem("Item");
+    bool readSnapshot(SnapshotReader& in) {
+        std::string name;
+        int32_t health, maxHealth, attack, gold, level, location;
+        uint8_t bossDefeated;
+        if (!in.getString(name) || !in.get(health) || !in.get(maxHealth) || !in.get(attack) ||
+            !in.get(gold) || !in.get(level) || !in.get(location) || !in.get(bossDefeated)) {
+            return false;
         }
-#    else
-        for (const auto& item : inventory_) {
-            state.addItem(item.name);
+
+        InventoryStore items;
+        if (!items.readSnapshot(in)) {
+            return false;
         }
-#    endif
 
-        if (state.saveToFile("dungeon_save.txt")) {
-            std::cout << "   ✅ Game saved successfully! (Session 3 file I/O)\n";
-        } else {
-            std::cout << "   ❌ Error: Could not save game!\n";
+        uint8_t hasWeapon;
+        std::string weaponName;
+        int32_t weaponDamage;
+        if (!in.get(hasWeapon) || !in.getString(weaponName) || !in.get(weaponDamage)) {
+            return false;
         }
-#else
-        // Fallback save
-        std::ofstream file("dungeon_save.txt");
-        if (!file.is_open()) {
-            std::cout << "   ❌ Error: Could not save game!\n";
-            return;
+
+        // Progress of each quest in QUESTS (empty without the quest module; a game with it
+        // starts such a save's quests afresh)
+        std::vector<uint32_t> questProgress;
+        if (!in.getColumn(questProgress)) {
+            return false;
+        }
+        if (WITH_QUESTS && !questProgress.empty() && questProgress.size() != std::size(QUESTS)) {
+            return false;
+        }
+
+        WorldStore world;
+        if (!world.readSnapshot(in)) {
+            return false;
+        }
+
+        EnemyStore enemies;
+        if (!enemies.readSnapshot(in)) {
+            return false;
+        }
+
+        // Cross-checks between sections
+        if (location < 0 || location >= static_cast<int32_t>(world.roomCount())) {
+            return false;
+        }
+        for (size_t room = 0; room < world.roomCount(); ++room) {
+            auto id = static_cast<WorldStore::RoomId>(room);
+            if (size_t{world.enemyBegin(id)} + world.enemyCount(id) > enemies.size()) {
+                return false;
+            }
         }
 
-        file << playerName_ << "\n";
-        file << playerHealth_ << "\n";
-        file << playerMaxHealth_ << "\n";
-        file << playerAttack_ << "\n";
-        file << playerGold_ << "\n";
-        file << playerLevel_ << "\n";
-        file << currentLocation_ << "\n";
-        file << bossDefeated_ << "\n";
+        // Everything parsed; commit
+        playerName_ = name;
+        playerHealth_ = health;
+        playerMaxHealth_ = maxHealth;
+        playerAttack_ = attack;
+        playerGold_ = gold;
+        playerLevel_ = level;
+        currentLocation_ = location;
+        bossDefeated_ = bossDefeated != 0;
+        world_ = std::move(world);
+        routes_.invalidate();
+        streamReplacedWorld();
+        currentLocationName_ = world_.name(currentLocation_);
+
+        enemies_ = std::move(enemies);
+
+        items_ = std::move(items);
+        if constexpr (WITH_INVENTORY) {
+#ifdef SESSION_02_AVAILABLE
+            inventory_ = std::make_unique<Inventory>(20);
+            for (ItemId id : items_) {
+                inventory_->addItem(std::string(itemDefinition(id).name),
+                                    itemDefinition(id).value);
+            }
+#endif
+        }
 
-        file.close();
-        std::cout << "   ✅ Game saved successfully!\n";
+        if constexpr (WITH_WEAPONS) {
+#ifdef SESSION_04_AVAILABLE
+            equippedWeapon_.reset();
+            equippedWeaponName_.clear();
+            if (hasWeapon) {
+                equippedWeapon_ = std::make_unique<Weapon>(weaponName, weaponDamage);
+                equippedWeaponName_ = weaponName;
+            }
 #endif
+        }
+
+        initializeQuests();
+        quests_.restoreProgress(questProgress);
+        return true;
+    }
+
+    // Full binary snapshot of the game and the world
+    void saveGame() {
+        out_ << "💾 Saving game...\n";
+
+        SnapshotWriter snapshot;
+        writeSnapshot(snapshot);
+        size_t bytes = snapshot.writeFile(savePath_ + ".bin");
+        if (bytes > 0) {
+            GAME_METRIC(++metrics_.saves);
+            GAME_METRIC(metrics_.saveBytes += bytes);
+            out_ << "   ✅ Game saved successfully! (" << bytes << " bytes)\n";
+        } else {
+            out_ << "   ❌ Error: Could not save game!\n";
+        }
     }
 
     void loadGame() {
-        std::cout << "📂 Loading game...\n";
+        out_ << "📂 Loading game...\n";
 
-#ifdef SESSION_03_AVAILABLE
-        GameState state;
-        if (state.loadFromFile("dungeon_save.txt")) {
-            playerName_ = state.getName();
-            playerLevel_ = state.getLevel();
-            playerGold_ = state.getGold();
-            currentLocationName_ = state.getLocation();
-
-            std::cout << "   ✅ Game loaded successfully! (Session 3 file I/O)\n";
-            std::cout << "   Loaded: " << playerName_ << ", Level " << playerLevel_ << ", "
-                      << playerGold_ << " gold\n";
-        } else {
-            std::cout << "   ❌ No save file found!\n";
+        SnapshotFile file;
+        SnapshotStatus status = file.open(savePath_ + ".bin");
+        if (status == SnapshotStatus::Missing) {
+            out_ << "   ❌ No save file found!\n";
+            return;
         }
-#else
-        // Fallback load
-        std::ifstream file("dungeon_save.txt");
-        if (!file.is_open()) {
-            std::cout << "   ❌ No save file found!\n";
+        if (status == SnapshotStatus::Unreadable) {
+            out_ << "   ❌ Could not read save file: " << file.error() << "\n";
+            return;
+        }
+        SnapshotReader reader = file.payload();
+        if (status != SnapshotStatus::Ok || !readSnapshot(reader)) {
+            out_ << "   ❌ Save file is damaged or from another version!\n";
             return;
         }
 
-        std::getline(file, playerName_);
-        file >> playerHealth_ >> playerMaxHealth_ >> playerAttack_ >> playerGold_;
-        file >> playerLevel_ >> currentLocation_ >> bossDefeated_;
-
-        file.close();
-        std::cout << "   ✅ Game loaded successfully!\n";
+        GAME_METRIC(++metrics_.loads);
+        GAME_METRIC(metrics_.loadBytes += file.fileSize());
+        out_ << "   ✅ Game loaded successfully!\n";
         describeLocation();
+    }
+
+    // Text export: player summary only (the format Session 3 reads and writes)
+    void exportGame() {
+        out_ << "💾 Exporting game...\n";
+        std::string path = savePath_ + ".txt";
+
+        if constexpr (WITH_SAVELOAD) {
+#ifdef SESSION_03_AVAILABLE
+            GameState state(playerName_, "Adventurer", playerLevel_, playerGold_,
+                            currentLocationName_);
+
+            // Add inventory items
+            for (ItemId id : items_) {
+                state.addItem(std::string(itemDefinition(id).name));
+            }
+
+            if (state.saveToFile(path)) {
+                out_ << "   ✅ Game exported successfully! (Session 3 file I/O)\n";
+            } else {
+                out_ << "   ❌ Error: Could not save game!\n";
+            }
+#endif
+        } else {
+            // Fallback save
+            std::ofstream file(path);
+            if (!file.is_open()) {
+                out_ << "   ❌ Error: Could not save game!\n";
+                return;
+            }
+
+            file << playerName_ << "\n";
+            file << playerHealth_ << "\n";
+            file << playerMaxHealth_ << "\n";
+            file << playerAttack_ << "\n";
+            file << playerGold_ << "\n";
+            file << playerLevel_ << "\n";
+            file << currentLocation_ << "\n";
+            file << bossDefeated_ << "\n";
+
+            file.close();
+            out_ << "   ✅ Game exported successfully!\n";
+        }
+    }
+
+    void importGame() {
+        out_ << "📂 Importing game...\n";
+        std::string path = savePath_ + ".txt";
+
+        if constexpr (WITH_SAVELOAD) {
+#ifdef SESSION_03_AVAILABLE
+            GameState state;
+            if (state.loadFromFile(path)) {
+                playerName_ = state.getName();
+                playerLevel_ = state.getLevel();
+                playerGold_ = state.getGold();
+                currentLocationName_ = state.getLocation();
+
+                out_ << "   ✅ Game imported successfully! (Session 3 file I/O)\n";
+                out_ << "   Loaded: " << playerName_ << ", Level " << playerLevel_ << ", "
+                     << playerGold_ << " gold\n";
+            } else {
+                out_ << "   ❌ No save file found!\n";
+            }
 #endif
+        } else {
+            // Fallback load
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                out_ << "   ❌ No save file found!\n";
+                return;
+            }
+
+            std::getline(file, playerName_);
+            file >> playerHealth_ >> playerMaxHealth_ >> playerAttack_ >> playerGold_;
+            file >> playerLevel_ >> currentLocation_ >> bossDefeated_;
+
+            file.close();
+            if (currentLocation_ < 0 || currentLocation_ >= static_cast<int>(world_.roomCount())) {
+                currentLocation_ = 0;
+            }
+            out_ << "   ✅ Game imported successfully!\n";
+            describeLocation();
+        }
     }
 };
+
+using GameEngine = BasicGameEngine<COMPILED_MODULES>;
@@ -0,0 +1,716 @@
+#include "game_host.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "game_engine.h"
+#include "game_metrics.h"
+#include "private_dir.h"
+#include "work_stealing_pool.h"
+
+#if defined(__linux__)
+#    include <fcntl.h>
+#    include <sys/epoll.h>
+#    include <sys/eventfd.h>
+#    include <sys/resource.h>
+#    include <sys/socket.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+
+#    include <cerrno>
+#    include <cstring>
+#    define CPP_QUEST_HAS_EPOLL 1
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+LatencySummary summarizeLatency(std::vector<float>& micros) {
+    LatencySummary summary;
+    summary.samples = micros.size();
+    if (micros.empty()) {
+        return summary;
+    }
+    std::sort(micros.begin(), micros.end());
+    auto at = [&](double fraction) {
+        size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(micros.size())));
+        return static_cast<double>(micros[std::max<size_t>(rank, 1) - 1]);
+    };
+    summary.p50Micros = at(0.50);
+    summary.p99Micros = at(0.99);
+    summary.maxMicros = micros.back();
+    return summary;
+}
+
+LatencySummary summarizeLatency(const LatencyHistogram& nanos) {
+    LatencySummary summary;
+    summary.samples = nanos.count();
+    if (summary.samples == 0) {
+        return summary;
+    }
+    summary.p50Micros = nanos.percentile(0.50) / 1000.0;
+    summary.p99Micros = nanos.percentile(0.99) / 1000.0;
+    summary.maxMicros = nanos.max() / 1000.0;
+    return summary;
+}
+
+namespace {
+
+float microsSince(Clock::time_point start) {
+    return std::chrono::duration<float, std::micro>(Clock::now() - start).count();
+}
+
+uint64_t nanosSince(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+}  // namespace
+
+#ifdef CPP_QUEST_HAS_EPOLL
+
+namespace {
+
+constexpr size_t MAX_LINE = 64 * 1024;  // longer lines close the connection
+
+void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK); }
+
+bool fillAddress(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+struct PendingLine {
+    std::string text;
+    Clock::time_point received;
+};
+
+struct HostSession {
+    HostSession(int socket, uint64_t sessionId)
+        : fd(socket), id(sessionId), game(noInput, output) {}
+
+    ~HostSession() {
+        std::error_code ignored;
+        std::filesystem::remove(savePath + ".bin", ignored);
+        std::filesystem::remove(savePath + ".txt", ignored);
+    }
+
+    const int fd;
+    const uint64_t id;
+    std::string savePath;
+
+    // Engine state; only the worker running the session touches these
+    std::istringstream noInput;  // input arrives through handleLine()
+    MemorySink output;
+    GameEngine game;
+    bool started = false;
+
+    // Shared between the I/O thread and the workers
+    std::mutex mutex;
+    std::deque<PendingLine> inbox;
+    std::string outbox;
+    bool scheduled = false;  // queued on or running in the pool
+    bool finished = false;   // game over; close once the outbox is sent
+
+    // I/O thread only
+    std::string readBuffer;
+    std::string writeBuffer;
+    bool closed = false;
+    bool wantsWrite = false;
+};
+
+using SessionPtr = std::shared_ptr<HostSession>;
+
+double processCpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    auto seconds = [](const timeval& t) { return t.tv_sec + t.tv_usec / 1e6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+long peakRssKilobytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+}  // namespace
+
+struct GameHost::Impl {
+    explicit Impl(const HostOptions& hostOptions) : options(hostOptions) {}
+
+    HostOptions options;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::thread ioThread;
+    std::unique_ptr<WorkStealingPool<SessionPtr>> pool;
+    std::atomic<bool> stopping{false};
+
+    // Session save files; this host's own, removed by stop()
+    PrivateDir saveDir;
+
+    // Sessions whose outbox has new output, handed from workers to the I/O thread
+    std::mutex readyMutex;
+    std::vector<SessionPtr> ready;
+
+    // I/O thread only
+    std::unordered_map<int, SessionPtr> sessions;
+    uint64_t nextSessionId = 0;
+    size_t peakSessions = 0;
+
+    // Per worker, written only by that worker; fixed size however long the host runs
+    std::vector<LatencyHistogram> latencies;
+    std::vector<size_t> commandLines;
+
+    Clock::time_point started;
+    double seconds = 0.0;
+    double cpuAtStart = 0.0;
+    double cpuSeconds = 0.0;
+
+    void runSession(SessionPtr& session, unsigned worker) {
+        HostSession& s = *session;
+        if (!s.started) {
+            s.started = true;
+            if (options.dungeon) {
+                s.game.loadDungeon(*options.dungeon);
+            }
+            s.game.initialize();
+            s.game.prompt();
+            publish(session);
+        }
+
+        for (;;) {
+            PendingLine line;
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (s.inbox.empty() || s.finished) {
+                    s.scheduled = false;
+                    return;
+                }
+                line = std::move(s.inbox.front());
+                s.inbox.pop_front();
+            }
+            s.game.handleLine(line.text);
+            publish(session);
+            latencies[worker].record(nanosSince(line.received));
+            ++commandLines[worker];
+        }
+    }
+
+    void publish(const SessionPtr& session) {
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            session->outbox += session->output.take();
+            session->finished = !session->game.isRunning();
+        }
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            ready.push_back(session);
+        }
+        wake();
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    void watch(int fd, uint32_t events, int op) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, op, fd, &event);
+    }
+
+    void acceptAll() {
+        for (;;) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            uint64_t id = nextSessionId++;
+            auto session = std::make_shared<HostSession>(fd, id);
+            session->savePath = (saveDir.path() / ("session_" + std::to_string(id))).string();
+            session->game.setSavePath(session->savePath);
+            session->game.seedRandom(GameRng::forStream(options.seed, id));
+            session->scheduled = true;
+
+            sessions.emplace(fd, session);
+            peakSessions = std::max(peakSessions, sessions.size());
+            watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+            pool->submit(session);
+        }
+    }
+
+    void closeSession(const SessionPtr& session) {
+        if (session->closed) {
+            return;
+        }
+        session->closed = true;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, session->fd, nullptr);
+        ::close(session->fd);
+        sessions.erase(session->fd);
+    }
+
+    // Reads what has arrived and queues complete lines; false once the client has gone
+    bool readFrom(const SessionPtr& session) {
+        HostSession& s = *session;
+        char buffer[4096];
+        bool open = true;
+        for (;;) {
+            ssize_t n = ::read(s.fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                s.readBuffer.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            open = false;  // end of file or a hard error
+            break;
+        }
+
+        auto now = Clock::now();
+        std::deque<PendingLine> lines;
+        size_t begin = 0;
+        for (size_t end = s.readBuffer.find('\n'); end != std::string::npos;
+             end = s.readBuffer.find('\n', begin)) {
+            size_t length = end - begin;
+            if (length > 0 && s.readBuffer[end - 1] == '\r') {
+                --length;
+            }
+            lines.push_back({s.readBuffer.substr(begin, length), now});
+            begin = end + 1;
+        }
+        s.readBuffer.erase(0, begin);
+        if (s.readBuffer.size() > MAX_LINE) {
+            return false;
+        }
+
+        if (!lines.empty()) {
+            bool submit = false;
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                for (auto& line : lines) {
+                    s.inbox.push_back(std::move(line));
+                }
+                submit = !s.scheduled;
+                s.scheduled = true;
+            }
+            if (submit) {
+                pool->submit(session);
+            }
+        }
+        return open;
+    }
+
+    void flush(const SessionPtr& session) {
+        HostSession& s = *session;
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.writeBuffer += s.outbox;
+            s.outbox.clear();
+            finished = s.finished;
+        }
+
+        size_t sent = 0;
+        while (sent < s.writeBuffer.size()) {
+            ssize_t n = ::send(s.fd, s.writeBuffer.data() + sent, s.writeBuffer.size() - sent,
+                               MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                closeSession(session);
+                return;
+            }
+        }
+        s.writeBuffer.erase(0, sent);
+
+        bool blocked = !s.writeBuffer.empty();
+        if (blocked != s.wantsWrite) {
+            s.wantsWrite = blocked;
+            watch(s.fd, EPOLLIN | EPOLLRDHUP | (blocked ? EPOLLOUT : 0u), EPOLL_CTL_MOD);
+        }
+        if (finished && !blocked) {
+            closeSession(session);
+        }
+    }
+
+    void drainReady() {
+        uint64_t count;
+        ssize_t ignored = ::read(wakeFd, &count, sizeof(count));
+        (void)ignored;
+
+        std::vector<SessionPtr> batch;
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            batch.swap(ready);
+        }
+        for (const auto& session : batch) {
+            if (!session->closed) {
+                flush(session);
+            }
+        }
+    }
+
+    void ioLoop() {
+        epoll_event events[256];
+        while (!stopping.load()) {
+            int count = epoll_wait(epollFd, events, 256, 100);
+            for (int i = 0; i < count; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll();
+                    continue;
+                }
+                if (fd == wakeFd) {
+                    drainReady();
+                    continue;
+                }
+                auto it = sessions.find(fd);
+                if (it == sessions.end()) {
+                    continue;
+                }
+                SessionPtr session = it->second;
+                if (events[i].events & EPOLLOUT) {
+                    flush(session);
+                }
+                if (!session->closed && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+                    if (!readFrom(session)) {
+                        closeSession(session);
+                    }
+                }
+            }
+        }
+
+        std::vector<SessionPtr> open;
+        for (const auto& entry : sessions) {
+            open.push_back(entry.second);
+        }
+        for (const auto& session : open) {
+            closeSession(session);
+        }
+    }
+};
+
+GameHost::GameHost(const HostOptions& options) : impl_(std::make_unique<Impl>(options)) {}
+
+GameHost::~GameHost() { stop(); }
+
+bool GameHost::start(std::string& error) {
+    Impl& h = *impl_;
+    sockaddr_un address;
+    if (!fillAddress(h.options.socketPath, address)) {
+        error = "Socket path is empty or too long: " + h.options.socketPath;
+        return false;
+    }
+    if (!h.saveDir.create("cpp_quest_host_", error)) {
+        return false;
+    }
+
+    h.listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    ::unlink(h.options.socketPath.c_str());
+    if (h.listenFd < 0 ||
+        bind(h.listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(h.listenFd, SOMAXCONN) != 0) {
+        error = "Could not listen on " + h.options.socketPath + ": " + std::strerror(errno);
+        if (h.listenFd >= 0) {
+            ::close(h.listenFd);
+            h.listenFd = -1;
+        }
+        h.saveDir.remove();
+        return false;
+    }
+
+    h.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    h.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    h.watch(h.listenFd, EPOLLIN, EPOLL_CTL_ADD);
+    h.watch(h.wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+
+    unsigned workers = h.options.workers;
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers = std::min(workers, HostOptions::MAX_WORKERS);
+    h.latencies.resize(workers);
+    h.commandLines.resize(workers);
+    h.pool = std::make_unique<WorkStealingPool<SessionPtr>>(
+        workers, [&h](SessionPtr& session, unsigned worker) { h.runSession(session, worker); });
+
+    h.started = Clock::now();
+    h.cpuAtStart = processCpuSeconds();
+    h.ioThread = std::thread([&h] { h.ioLoop(); });
+    return true;
+}
+
+void GameHost::stop() {
+    Impl& h = *impl_;
+    if (!h.ioThread.joinable()) {
+        return;
+    }
+    h.stopping = true;
+    h.wake();
+    h.ioThread.join();
+    h.pool.reset();  // runs what is still queued, then joins the workers
+    h.ready.clear();
+
+    h.seconds = std::chrono::duration<double>(Clock::now() - h.started).count();
+    h.cpuSeconds = processCpuSeconds() - h.cpuAtStart;
+
+    ::close(h.listenFd);
+    ::close(h.epollFd);
+    ::close(h.wakeFd);
+    ::unlink(h.options.socketPath.c_str());
+    h.saveDir.remove();  // every session is gone by now
+}
+
+HostReport GameHost::report() const {
+    const Impl& h = *impl_;
+    HostReport report;
+    report.workers = static_cast<unsigned>(h.latencies.size());
+    report.seconds = h.seconds;
+    report.cpuSeconds = h.cpuSeconds;
+    report.sessions = h.nextSessionId;
+    report.peakSessions = h.peakSessions;
+    report.peakRssKilobytes = peakRssKilobytes();
+
+    LatencyHistogram all;
+    for (size_t w = 0; w < h.latencies.size(); ++w) {
+        all.merge(h.latencies[w]);
+        report.commandLines += h.commandLines[w];
+    }
+    report.latency = summarizeLatency(all);
+    return report;
+}
+
+// Stand-in client -------------------------------------------------------------
+
+namespace {
+
+struct ClientConnection {
+    int fd = -1;
+    std::vector<std::string> commands;
+    size_t next = 0;
+    std::string received;
+    bool waiting = false;
+    Clock::time_point sent;
+};
+
+// One request per command (with its argument, so "go north" stays together)
+std::vector<std::string> splitCommands(const std::string& script) {
+    std::vector<std::string> commands;
+    CommandParser parser;
+    parser.reset(script);
+    ParsedCommand command;
+    while (parser.next(command)) {
+        std::string text(command.verb);
+        if (!command.argument.empty()) {
+            text += " ";
+            text += command.argument;
+        }
+        commands.push_back(std::move(text));
+    }
+    return commands;
+}
+
+bool endsWithPrompt(const std::string& text) {
+    return text.size() >= 3 && text.compare(text.size() - 3, 3, "\n> ") == 0;
+}
+
+}  // namespace
+
+ClientReport runHostClients(const ClientOptions& options) {
+    ClientReport report;
+    if (options.scripts.empty()) {
+        return report;
+    }
+
+    sockaddr_un address;
+    if (!fillAddress(options.socketPath, address)) {
+        report.failed = options.clients;
+        return report;
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<ClientConnection> clients(options.clients);
+    std::vector<float> latencies;
+    size_t active = 0;
+    auto start = Clock::now();
+
+    for (size_t i = 0; i < clients.size(); ++i) {
+        ClientConnection& c = clients[i];
+        c.commands = splitCommands(options.scripts[i % options.scripts.size()]);
+        c.fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (c.fd < 0 ||
+            connect(c.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (c.fd >= 0) {
+                ::close(c.fd);
+                c.fd = -1;
+            }
+            ++report.failed;
+            continue;
+        }
+        setNonBlocking(c.fd);
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, c.fd, &event);
+        ++active;
+    }
+
+    auto finish = [&](ClientConnection& c, bool ok) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+        ::close(c.fd);
+        c.fd = -1;
+        --active;
+        ++(ok ? report.sessions : report.failed);
+    };
+
+    epoll_event events[256];
+    while (active > 0) {
+        int count = epoll_wait(epollFd, events, 256, 10000);
+        if (count <= 0) {
+            break;  // nothing for 10 s: the host is gone or stuck
+        }
+        for (int e = 0; e < count; ++e) {
+            ClientConnection& c = clients[events[e].data.u64];
+            if (c.fd < 0) {
+                continue;
+            }
+
+            char buffer[8192];
+            bool closed = false;
+            for (;;) {
+                ssize_t n = ::read(c.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    c.received.append(buffer, static_cast<size_t>(n));
+                } else if (n < 0 && errno == EINTR) {
+                    continue;
+                } else {
+                    closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+                    break;
+                }
+            }
+
+            if (closed) {
+                // The host closes the connection when the game ends
+                if (c.waiting) {
+                    latencies.push_back(microsSince(c.sent));
+                    ++report.commands;
+                }
+                finish(c, c.waiting || c.next == c.commands.size());
+                continue;
+            }
+            if (!endsWithPrompt(c.received)) {
+                continue;  // the rest of the turn is still on its way
+            }
+
+            if (c.waiting) {
+                latencies.push_back(microsSince(c.sent));
+                ++report.commands;
+            }
+            c.received.clear();
+            if (c.next == c.commands.size()) {
+                finish(c, true);
+                continue;
+            }
+            std::string request = c.commands[c.next++] + "\n";
+            c.sent = Clock::now();
+            c.waiting = true;
+            if (::send(c.fd, request.data(), request.size(), MSG_NOSIGNAL) !=
+                static_cast<ssize_t>(request.size())) {
+                finish(c, false);
+            }
+        }
+    }
+
+    for (auto& c : clients) {
+        if (c.fd >= 0) {
+            finish(c, false);
+        }
+    }
+    ::close(epollFd);
+
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report.latency = summarizeLatency(latencies);
+    return report;
+}
+
+#else  // no epoll
+
+struct GameHost::Impl {
+    explicit Impl(const HostOptions&) {}
+};
+
+GameHost::GameHost(const HostOptions& options) : impl_(std::make_unique<Impl>(options)) {}
+GameHost::~GameHost() = default;
+
+bool GameHost::start(std::string& error) {
+    error = "Hosting needs epoll, which this platform does not have";
+    return false;
+}
+
+void GameHost::stop() {}
+
+HostReport GameHost::report() const { return {}; }
+
+ClientReport runHostClients(const ClientOptions& options) {
+    ClientReport report;
+    report.failed = options.clients;
+    return report;
+}
+
+#endif
+
+void printHostReport(std::ostream& out, const HostReport& report) {
+    out << "Game host\n";
+    out << "  Workers:      " << report.workers << "\n";
+    out << "  Sessions:     " << report.sessions << " (peak " << report.peakSessions
+        << " at once)\n";
+    out << "  Commands:     " << report.commandLines << " lines in " << report.seconds << " s\n";
+    out << "  Latency:      p50 " << report.latency.p50Micros << " us, p99 "
+        << report.latency.p99Micros << " us, max " << report.latency.maxMicros
+        << " us (arrival to output ready)\n";
+    if (report.cpuSeconds > 0.0) {
+        out << "  CPU time:     " << report.cpuSeconds << " s ("
+            << static_cast<long long>(report.sessions / report.cpuSeconds)
+            << " sessions and "
+            << static_cast<long long>(report.commandLines / report.cpuSeconds)
+            << " commands per core-second)\n";
+    }
+    if (report.peakRssKilobytes > 0) {
+        out << "  Peak RSS:     " << report.peakRssKilobytes / 1024.0 << " MiB\n";
+    }
+}
+
+void printClientReport(std::ostream& out, const ClientReport& report) {
+    out << "Stand-in clients\n";
+    out << "  Sessions:     " << report.sessions << " played, " << report.failed << " failed\n";
+    out << "  Commands:     " << report.commands << " in " << report.seconds << " s ("
+        << static_cast<long long>(report.seconds > 0.0 ? report.commands / report.seconds : 0)
+        << "/s)\n";
+    out << "  Round trip:   p50 " << report.latency.p50Micros << " us, p99 "
+        << report.latency.p99Micros << " us, max " << report.latency.maxMicros << " us\n";
+}
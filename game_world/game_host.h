@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct GeneratedDungeon;
+class LatencyHistogram;
+
+/**
+ * Multi-session game host
+ *
+ * Serves many players from one process over a Unix-domain socket. Each
+ * connection gets its own GameEngine (own output sink, own random stream and
+ * save file); a line sent on the connection is played with
+ * GameEngine::handleLine() and the output goes back on the same connection.
+ *
+ * One I/O thread multiplexes every connection with epoll. Commands run on a
+ * work-stealing worker pool; a session's lines run one at a time, in order,
+ * on whichever worker picks the session up.
+ *
+ * runHostClients() is a stand-in client for local testing and measurement: it
+ * opens many connections and plays one script on each, a command at a time,
+ * waiting for the prompt before sending the next.
+ *
+ * Needs epoll (Linux); elsewhere start() reports that hosting is unavailable.
+ */
+
+struct HostOptions {
+    // Each worker has a thread and a queue; larger counts are lowered to this
+    static constexpr unsigned MAX_WORKERS = 256;
+
+    std::string socketPath;
+    // 0 means one worker per hardware thread
+    unsigned workers = 0;
+    // Session i plays with GameRng::forStream(seed, i)
+    uint64_t seed = 1;
+    // Generated dungeon every session starts in (copied per session); null for the built-in one
+    const GeneratedDungeon* dungeon = nullptr;
+};
+
+struct LatencySummary {
+    size_t samples = 0;
+    double p50Micros = 0.0;
+    double p99Micros = 0.0;
+    double maxMicros = 0.0;
+};
+
+// Sorts the samples (microseconds) in place
+LatencySummary summarizeLatency(std::vector<float>& micros);
+// From a histogram of nanoseconds; percentiles are within its 12.5% buckets
+LatencySummary summarizeLatency(const LatencyHistogram& nanos);
+
+struct HostReport {
+    unsigned workers = 0;
+    double seconds = 0.0;
+    double cpuSeconds = 0.0;  // user + system time of the whole process; 0 where unsupported
+    size_t sessions = 0;
+    size_t peakSessions = 0;
+    size_t commandLines = 0;
+    size_t steals = 0;
+    long peakRssKilobytes = 0;
+    // From a line arriving on the socket to its output being ready to send
+    LatencySummary latency;
+};
+
+class GameHost {
+   public:
+    explicit GameHost(const HostOptions& options);
+    ~GameHost();
+    GameHost(const GameHost&) = delete;
+    GameHost& operator=(const GameHost&) = delete;
+
+    // Binds the socket and starts the I/O thread and the workers; false (with a message) on error
+    bool start(std::string& error);
+    // Closes every connection and joins all threads
+    void stop();
+
+    HostReport report() const;
+
+   private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+struct ClientOptions {
+    std::string socketPath;
+    // Client i plays scripts[i % size], one whitespace-separated command per request
+    std::vector<std::string> scripts;
+    size_t clients = 100;
+};
+
+struct ClientReport {
+    size_t sessions = 0;
+    size_t failed = 0;  // connections that could not be made or broke off
+    size_t commands = 0;
+    double seconds = 0.0;
+    // Round trip: command sent to its prompt received
+    LatencySummary latency;
+};
+
+// All clients run concurrently on the calling thread
+ClientReport runHostClients(const ClientOptions& options);
+
+void printHostReport(std::ostream& out, const HostReport& report);
+void printClientReport(std::ostream& out, const ClientReport& report);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Deterministic random numbers
+ *
+ * GameRng is xoshiro256**: 32 bytes of state, a few shifts and adds per draw,
+ * no locks and no global state. Every engine owns one, so parallel sessions
+ * never share a generator, and the same seed always replays the same game.
+ *
+ * forStream() derives independent generators from one seed and a stream id
+ * (a session index, a worker id), so parallel runs are reproducible whatever
+ * the thread count or scheduling.
+ */
+
+// splitmix64 finalizer: a cheap, well-mixed hash of a 64-bit counter
+constexpr uint64_t splitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+class GameRng {
+   public:
+    explicit GameRng(uint64_t seed = 1) {
+        // splitmix64 sequence, as recommended for seeding xoshiro (never all zero)
+        for (auto& word : state_) {
+            word = splitMix64(seed);
+            seed += 0x9E3779B97F4A7C15ull;
+        }
+    }
+
+    static GameRng forStream(uint64_t seed, uint64_t stream) {
+        return GameRng(splitMix64(seed) ^ splitMix64(~stream));
+    }
+
+    uint64_t next() {
+        ++draws_;
+        uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, n) for n > 0 (multiply-shift on the high 32 bits; bias below 2^-32 * n)
+    int below(int n) {
+        return static_cast<int>(((next() >> 32) * static_cast<uint32_t>(n)) >> 32);
+    }
+
+    // Values drawn so far; the command journal checks replays against it
+    uint64_t draws() const { return draws_; }
+
+   private:
+    static constexpr uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t state_[4];
+    uint64_t draws_ = 0;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "builtin_dungeon.h"
+#include "command_journal.h"
+#include "command_table.h"
+#include "item_registry.h"
+#include "type_report.h"
+#include "world_chunks.h"
+
+/**
+ * Sizes, limits and layouts of the types the game is built from
+ *
+ * The arithmetic types (char through long double, and the fixed-width
+ * integers the stores use) and the structs the game keeps many of: the
+ * built-in dungeon's room, enemy and treasure tables, item definitions, a
+ * streamed room's record, parsed commands and journal records. The whole
+ * report is text in the binary; --type-report prints it.
+ */
+
+template <>
+struct typereport::Layout<builtin::RoomDefinition> {
+    static constexpr std::string_view name = "builtin::RoomDefinition";
+    static constexpr Field fields[] = {
+        TYPE_REPORT_FIELD(builtin::RoomDefinition, name),
+        TYPE_REPORT_FIELD(builtin::RoomDefinition, description),
+        TYPE_REPORT_FIELD(builtin::RoomDefinition, exits),
+    };
+};
+
+template <>
+struct typereport::Layout<builtin::EnemyDefinition> {
+    static constexpr std::string_view name = "builtin::EnemyDefinition";
+    static constexpr Field fields[] = {
+        TYPE_REPORT_FIELD(builtin::EnemyDefinition, room),
+        TYPE_REPORT_FIELD(builtin::EnemyDefinition, name),
+        TYPE_REPORT_FIELD(builtin::EnemyDefinition, health),
+        TYPE_REPORT_FIELD(builtin::EnemyDefinition, attack),
+        TYPE_REPORT_FIELD(builtin::EnemyDefinition, flags),
+    };
+};
+
+template <>
+struct typereport::Layout<builtin::TreasureDefinition> {
+    static constexpr std::string_view name = "builtin::TreasureDefinition";
+    static constexpr Field fields[] = {
+        TYPE_REPORT_FIELD(builtin::TreasureDefinition, room),
+        TYPE_REPORT_FIELD(builtin::TreasureDefinition, item),
+    };
+};
+
+template <>
+struct typereport::Layout<ItemDefinition> {
+    static constexpr std::string_view name = "ItemDefinition";
+    static constexpr Field fields[] = {
+        TYPE_REPORT_FIELD(ItemDefinition, name),
+        TYPE_REPORT_FIELD(ItemDefinition, value),
+        TYPE_REPORT_FIELD(ItemDefinition, weight),
+        TYPE_REPORT_FIELD(ItemDefinition, rarity),
+        TYPE_REPORT_FIELD(ItemDefinition, weaponDamage),
+    };
+};
+
+template <>
+struct typereport::Layout<WorldChunks::Room> {
+    static constexpr std::string_view name = "WorldChunks::Room";
+    static constexpr Field fields[] = {
+        TYPE_REPORT_FIELD(WorldChunks::Room, nameId),
+        TYPE_REPORT_FIELD(WorldChunks::Room, descriptionId),
+        TYPE_REPORT_FIELD(WorldChunks::Room, exits),
+        TYPE_REPORT_FIELD(WorldChunks::Room, enemyBegin),
+        TYPE_REPORT_FIELD(WorldChunks::Room, enemyCount),
+        TYPE_REPORT_FIELD(WorldChunks::Room, treasureCount),
+        TYPE_REPORT_FIELD(WorldChunks::Room, treasureBegin),
+        TYPE_REPORT_FIELD(WorldChunks::Room, visited),
+    };
+};
+
+template <>
+struct typereport::Layout<ParsedCommand> {
+    static constexpr std::string_view name = "ParsedCommand";
+    static constexpr Field fields[] = {
+        TYPE_REPORT_FIELD(ParsedCommand, command),
+        TYPE_REPORT_FIELD(ParsedCommand, verb),
+        TYPE_REPORT_FIELD(ParsedCommand, argument),
+    };
+};
+
+template <>
+struct typereport::Layout<JournalRecord> {
+    static constexpr std::string_view name = "JournalRecord";
+    static constexpr Field fields[] = {
+        TYPE_REPORT_FIELD(JournalRecord, command),
+        TYPE_REPORT_FIELD(JournalRecord, argument),
+        TYPE_REPORT_FIELD(JournalRecord, draws),
+    };
+};
+
+struct GameTypeReport {
+    template <typename Out>
+    static constexpr void write(Out& out) {
+        using namespace typereport;
+        out.put("Arithmetic types\n");
+        limits<char>(out, "char");
+        limits<signed char>(out, "signed char");
+        limits<unsigned char>(out, "unsigned char");
+        limits<short>(out, "short");
+        limits<unsigned short>(out, "unsigned short");
+        limits<int>(out, "int");
+        limits<unsigned>(out, "unsigned");
+        limits<long>(out, "long");
+        limits<unsigned long>(out, "unsigned long");
+        limits<long long>(out, "long long");
+        limits<unsigned long long>(out, "unsigned long long");
+        limits<bool>(out, "bool");
+        limits<float>(out, "float");
+        limits<double>(out, "double");
+        limits<long double>(out, "long double");
+        limits<int8_t>(out, "int8_t");
+        limits<uint8_t>(out, "uint8_t");
+        limits<int16_t>(out, "int16_t");
+        limits<uint16_t>(out, "uint16_t");
+        limits<int32_t>(out, "int32_t");
+        limits<uint32_t>(out, "uint32_t");
+        limits<int64_t>(out, "int64_t");
+        limits<uint64_t>(out, "uint64_t");
+
+        out.put("\nGame structs\n");
+        layout<builtin::RoomDefinition>(out);
+        layout<builtin::EnemyDefinition>(out);
+        layout<builtin::TreasureDefinition>(out);
+        layout<ItemDefinition>(out);
+        layout<WorldChunks::Room>(out);
+        layout<ParsedCommand>(out);
+        layout<JournalRecord>(out);
+    }
+};
+
+inline std::string_view gameTypeReport() { return typereport::prebuilt<GameTypeReport>(); }
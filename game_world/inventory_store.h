@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "block_pool.h"
+#include "item_registry.h"
+#include "snapshot.h"
+
+/**
+ * The items a player carries
+ *
+ * Entries are item ids (see item_registry.h) in a BlockPool, threaded on two
+ * intrusive lists: every entry in pickup order, and the entries of one item
+ * id. The per-id lists are the secondary indexes: walking ITEMS_BY_VALUE
+ * over them visits items by value, and filtering the ids by rarity visits one
+ * rarity, each without touching the rest of the bag. Counts per id and per
+ * rarity and the gold and weight totals are kept up to date on every add and
+ * remove, so reading them is O(1).
+ *
+ * Iteration yields ids straight from the pool; nothing is copied or
+ * allocated, which is what save, export and the inventory listing rely on
+ * for bags of 10^5 items.
+ */
+class InventoryStore {
+   public:
+    using Handle = uint32_t;
+    static constexpr Handle NONE = BlockPool<int>::NONE;
+
+    InventoryStore() { clear(); }
+
+    Handle add(ItemId item) {
+        Handle handle = pool_.allocate();
+        Entry& entry = pool_[handle];
+        entry.item = item;
+        link(handle, head_, tail_, &Entry::prev, &Entry::next);
+        link(handle, firstOf_[item], lastOf_[item], &Entry::prevSame, &Entry::nextSame);
+        tally(item, +1);
+        return handle;
+    }
+
+    void remove(Handle handle) {
+        ItemId item = pool_[handle].item;
+        unlink(handle, head_, tail_, &Entry::prev, &Entry::next);
+        unlink(handle, firstOf_[item], lastOf_[item], &Entry::prevSame, &Entry::nextSame);
+        tally(item, -1);
+        pool_.release(handle);
+    }
+
+    void clear() {
+        pool_.clear();
+        head_ = tail_ = NONE;
+        firstOf_.fill(NONE);
+        lastOf_.fill(NONE);
+        countOf_.fill(0);
+        rarityCount_.fill(0);
+        size_ = 0;
+        gold_ = 0;
+        weight_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    int64_t gold() const { return gold_; }
+    int64_t weight() const { return weight_; }
+    size_t count(ItemId item) const { return countOf_[item]; }
+    size_t count(quest::Rarity rarity) const {
+        return rarityCount_[static_cast<size_t>(rarity)];
+    }
+    ItemId item(Handle handle) const { return pool_[handle].item; }
+
+    // Pickup order
+    class Iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ItemId;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ItemId*;
+        using reference = const ItemId&;
+
+        Iterator() = default;
+        Iterator(const InventoryStore* store, Handle handle) : store_(store), handle_(handle) {}
+
+        reference operator*() const { return store_->pool_[handle_].item; }
+        Iterator& operator++() {
+            handle_ = store_->pool_[handle_].next;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const Iterator& other) const { return handle_ == other.handle_; }
+        bool operator!=(const Iterator& other) const { return handle_ != other.handle_; }
+
+        Handle handle() const { return handle_; }
+
+       private:
+        const InventoryStore* store_ = nullptr;
+        Handle handle_ = NONE;
+    };
+
+    Iterator begin() const { return Iterator(this, head_); }
+    Iterator end() const { return Iterator(this, NONE); }
+
+    // fn(Handle, ItemId) for every item worth at least minValue, most valuable first
+    template <typename Fn>
+    void forEachByValue(Fn&& fn, int minValue = 0) const {
+        for (ItemId item : ITEMS_BY_VALUE) {
+            if (itemDefinition(item).value < minValue) {
+                break;
+            }
+            forEachOf(item, fn);
+        }
+    }
+
+    // fn(Handle, ItemId) for every item of one rarity, by id and then pickup order
+    template <typename Fn>
+    void forEachOfRarity(quest::Rarity rarity, Fn&& fn) const {
+        if (count(rarity) == 0) {
+            return;
+        }
+        for (ItemId item = 0; item < ITEM_COUNT; ++item) {
+            if (itemDefinition(item).rarity == rarity) {
+                forEachOf(item, fn);
+            }
+        }
+    }
+
+    // fn(Handle, ItemId) for every copy of one item, in pickup order
+    template <typename Fn>
+    void forEachOf(ItemId item, Fn&& fn) const {
+        for (Handle h = firstOf_[item]; h != NONE; h = pool_[h].nextSame) {
+            fn(h, item);
+        }
+    }
+
+    size_t memoryBytes() const { return sizeof(*this) + pool_.memoryBytes(); }
+
+    // Item ids in pickup order, written straight into the snapshot
+    void writeSnapshot(SnapshotWriter& out) const {
+        out.putColumn<ItemId>(size_, [this](ItemId* column) {
+            for (ItemId item : *this) {
+                *column++ = item;
+            }
+        });
+    }
+
+    bool readSnapshot(SnapshotReader& in) {
+        std::vector<ItemId> items;
+        if (!in.getColumn(items)) {
+            return false;
+        }
+        clear();
+        for (ItemId item : items) {
+            if (item >= ITEM_COUNT) {
+                return false;
+            }
+            add(item);
+        }
+        return true;
+    }
+
+   private:
+    struct Entry {
+        ItemId item = 0;
+        Handle prev = NONE;
+        Handle next = NONE;
+        Handle prevSame = NONE;
+        Handle nextSame = NONE;
+    };
+
+    using Link = Handle Entry::*;
+
+    // Appends handle to the list [first, last] threaded through the prev/next fields
+    void link(Handle handle, Handle& first, Handle& last, Link prev, Link next) {
+        Entry& entry = pool_[handle];
+        entry.*prev = last;
+        entry.*next = NONE;
+        if (last == NONE) {
+            first = handle;
+        } else {
+            pool_[last].*next = handle;
+        }
+        last = handle;
+    }
+
+    void unlink(Handle handle, Handle& first, Handle& last, Link prev, Link next) {
+        const Entry& entry = pool_[handle];
+        if (entry.*prev == NONE) {
+            first = entry.*next;
+        } else {
+            pool_[entry.*prev].*next = entry.*next;
+        }
+        if (entry.*next == NONE) {
+            last = entry.*prev;
+        } else {
+            pool_[entry.*next].*prev = entry.*prev;
+        }
+    }
+
+    void tally(ItemId item, int delta) {
+        const ItemDefinition& definition = itemDefinition(item);
+        countOf_[item] += delta;
+        rarityCount_[static_cast<size_t>(definition.rarity)] += delta;
+        size_ += delta;
+        gold_ += delta * definition.value;
+        weight_ += delta * definition.weight;
+    }
+
+    BlockPool<Entry> pool_;
+    Handle head_;
+    Handle tail_;
+
+    // Secondary indexes: the entries of each item id, and counts per id and rarity
+    std::array<Handle, ITEM_COUNT> firstOf_;
+    std::array<Handle, ITEM_COUNT> lastOf_;
+    std::array<uint32_t, ITEM_COUNT> countOf_;
+    std::array<uint32_t, RARITY_COUNT> rarityCount_;
+
+    // Running totals
+    size_t size_;
+    int64_t gold_;
+    int64_t weight_;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "../common/game_types.h"
+
+/**
+ * Item definitions
+ *
+ * Every item that can lie in the dungeon has a definition with a stable id
+ * (its index in ITEM_DEFINITIONS) and traits worked out at compile time: gold
+ * value, weight, weapon damage and rarity. Rooms and snapshots store the
+ * 16-bit id, and loot reads the traits instead of looking at names.
+ *
+ * Ids are saved in snapshots, so new items go at the end of the table.
+ */
+
+using ItemId = uint16_t;
+
+// Damage a weapon adds when equipped (0 if it is not a weapon): swords and daggers, a tenth
+// of their value
+constexpr int weaponBonus(std::string_view itemName, int value) {
+    bool weapon = itemName.find("Sword") != std::string_view::npos ||
+                  itemName.find("Dagger") != std::string_view::npos;
+    return weapon ? value / 10 : 0;
+}
+
+struct ItemDefinition {
+    std::string_view name;
+    int value;
+    int weight;
+    quest::Rarity rarity;
+    int weaponDamage = weaponBonus(name, value);
+};
+
+inline constexpr ItemDefinition ITEM_DEFINITIONS[] = {
+    {"Rusty Dagger", 10, 2, quest::Rarity::Common},
+    {"Iron Sword", 50, 6, quest::Rarity::Uncommon},
+    {"Leather Armor", 40, 10, quest::Rarity::Common},
+    {"Health Potion", 25, 1, quest::Rarity::Common},
+    {"Gold Coins", 100, 1, quest::Rarity::Uncommon},
+    {"Steel Sword", 100, 7, quest::Rarity::Rare},
+    {"Magic Amulet", 200, 1, quest::Rarity::Epic},
+    {"Gold Pile", 500, 5, quest::Rarity::Rare},
+    {"Dragon Hoard", 5000, 40, quest::Rarity::Legendary},
+};
+
+constexpr ItemId ITEM_COUNT = sizeof(ITEM_DEFINITIONS) / sizeof(ITEM_DEFINITIONS[0]);
+constexpr ItemId NO_ITEM = 0xFFFF;
+
+// Id of the item with this name, or NO_ITEM. Meant for constants and loading, not hot paths.
+constexpr ItemId findItem(std::string_view name) {
+    for (ItemId id = 0; id < ITEM_COUNT; ++id) {
+        if (ITEM_DEFINITIONS[id].name == name) {
+            return id;
+        }
+    }
+    return NO_ITEM;
+}
+
+constexpr const ItemDefinition& itemDefinition(ItemId id) { return ITEM_DEFINITIONS[id]; }
+
+constexpr size_t RARITY_COUNT = static_cast<size_t>(quest::Rarity::Legendary) + 1;
+
+// Item ids from the most to the least valuable (ties keep id order)
+inline constexpr std::array<ItemId, ITEM_COUNT> ITEMS_BY_VALUE = [] {
+    std::array<ItemId, ITEM_COUNT> order{};
+    for (ItemId id = 0; id < ITEM_COUNT; ++id) {
+        order[id] = id;
+    }
+    std::sort(order.begin(), order.end(), [](ItemId a, ItemId b) {
+        int va = ITEM_DEFINITIONS[a].value;
+        int vb = ITEM_DEFINITIONS[b].value;
+        return va != vb ? va > vb : a < b;
+    });
+    return order;
+}();
+
+// Ids used by the built-in dungeon and the generator; a misspelling fails to compile
+namespace items {
+constexpr ItemId RUSTY_DAGGER = findItem("Rusty Dagger");
+constexpr ItemId IRON_SWORD = findItem("Iron Sword");
+constexpr ItemId LEATHER_ARMOR = findItem("Leather Armor");
+constexpr ItemId HEALTH_POTION = findItem("Health Potion");
+constexpr ItemId GOLD_COINS = findItem("Gold Coins");
+constexpr ItemId STEEL_SWORD = findItem("Steel Sword");
+constexpr ItemId MAGIC_AMULET = findItem("Magic Amulet");
+constexpr ItemId GOLD_PILE = findItem("Gold Pile");
+constexpr ItemId DRAGON_HOARD = findItem("Dragon Hoard");
+
+static_assert(RUSTY_DAGGER != NO_ITEM && IRON_SWORD != NO_ITEM && LEATHER_ARMOR != NO_ITEM &&
+              HEALTH_POTION != NO_ITEM && GOLD_COINS != NO_ITEM && STEEL_SWORD != NO_ITEM &&
+              MAGIC_AMULET != NO_ITEM && GOLD_PILE != NO_ITEM && DRAGON_HOARD != NO_ITEM);
+}  // namespace items
@@ -1,13 +1,415 @@
 #include "game_engine.h"
 
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
 
-int main() {
-    GameEngine game;
+#include "batch_runner.h"
+#include "combat_sim.h"
+#include "dungeon_generator.h"
+#include "game_host.h"
+#include "game_type_report.h"
+#include "output_frame.h"
+#include "session_modules.h"
+#include "startup_report.h"
 
-    game.initialize();
-    game.run();
-    game.shutdown();
+namespace {
 
+// Highest session number --session-level accepts
+constexpr int LAST_SESSION = 13;
+
+// Reads text as a whole decimal number from min to max; false for anything else (a sign,
+// trailing characters, a value out of range)
+bool parseNumber(const char* text, unsigned long long min, unsigned long long max,
+                 unsigned long long& value) {
+    if (!std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoull(text, &end, 10);
+    return *end == '\0' && errno == 0 && value >= min && value <= max;
+}
+
+// Parses a count option's value, at least 1; prints why not and returns false if it isn't one
+bool parseCount(const std::string& option, const char* text, size_t& count) {
+    unsigned long long value = 0;
+    if (!parseNumber(text, 1, SIZE_MAX, value)) {
+        std::cerr << option << " needs a number of at least 1, not '" << text << "'\n";
+        return false;
+    }
+    count = static_cast<size_t>(value);
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n";
+    std::cout << "  (no options)             Play interactively\n";
+    std::cout << "  --batch <script-file>    Run headless sessions from a script file\n";
+    std::cout << "                           (one script per line, commands separated by spaces)\n";
+    std::cout << "  --sessions <n>           Number of batch sessions (default: 1000)\n";
+    std::cout << "  --threads <n>            Batch worker threads (default: all cores)\n";
+    std::cout << "  --capture                Print every batch session's output\n";
+    std::cout << "  --rooms <n>              Play in a generated dungeon of n rooms\n";
+    std::cout << "                           (2 to 10000000)\n";
+    std::cout << "  --seed <n>               Seed for generation, combat and batch runs (default: 1;\n";
+    std::cout << "                           interactive games are random unless given)\n";
+    std::cout << "  --stream-world <file>    Keep the rooms in a chunk file while playing, with\n";
+    std::cout << "                           only recently used chunks in memory (interactive\n";
+    std::cout << "                           play only)\n";
+    std::cout << "  --resident-chunks <n>    Chunks of 1024 rooms kept in memory (default: 64)\n";
+    std::cout << "  --gen-report             Generate the dungeon, report time and memory, exit\n";
+    std::cout << "  --startup-report         Start a game, report the time to its first prompt\n";
+    std::cout << "                           phase by phase, exit\n";
+    std::cout << "  --type-report            Print sizes, limits and struct layouts, exit\n";
+    std::cout << "  --combat-sim             Simulate every enemy/weapon matchup, report, exit\n";
+    std::cout << "  --fights <n>             Fights per matchup (default: 1000000)\n";
+    std::cout << "  --scalar                 Don't use AVX2 in --combat-sim\n";
+    std::cout << "  --host <socket>          Serve many players over a Unix socket (until Ctrl-C)\n";
+    std::cout << "  --clients <n>            With --host or --connect: play the --batch scripts\n";
+    std::cout << "                           on n concurrent stand-in clients, report, exit\n";
+    std::cout << "  --connect <socket>       Run stand-in clients against a running host\n";
+    std::cout << "  --output <file>          Write the game's output to a file instead of stdout\n";
+    std::cout << "                           (not with --batch)\n";
+    std::cout << "  --journal <file>         Journal every command to a file; if it exists, replay\n";
+    std::cout << "                           it first and carry on from where it stopped\n";
+    std::cout << "                           (not with --batch)\n";
+    std::cout << "  --session-level <n>      Play with the session modules up to Session n, 0-13\n";
+    std::cout << "                           (default: every module compiled in; not with\n";
+    std::cout << "                           --batch or --host)\n";
+    std::cout << "  --modules                List the session modules and which are selected, exit\n";
+#if CPP_QUEST_METRICS
+    std::cout << "  --metrics <file>         Write engine metrics as JSON to a file on exit\n";
+#endif
+}
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) { stopRequested = 1; }
+
+int runHostMode(const std::string& hostSocket, const std::string& connectSocket, size_t clients,
+                const std::string& scriptFile, const BatchOptions& batch) {
+    ClientOptions clientOptions;
+    if (clients > 0) {
+        if (scriptFile.empty() || !loadBatchScripts(scriptFile, clientOptions.scripts) ||
+            clientOptions.scripts.empty()) {
+            std::cerr << "--clients needs a --batch script file with commands\n";
+            return 1;
+        }
+        clientOptions.clients = clients;
+    }
+
+    if (hostSocket.empty()) {
+        clientOptions.socketPath = connectSocket;
+        printClientReport(std::cout, runHostClients(clientOptions));
+        return 0;
+    }
+
+    HostOptions hostOptions;
+    hostOptions.socketPath = hostSocket;
+    hostOptions.workers = batch.threads;
+    hostOptions.seed = batch.seed;
+    hostOptions.dungeon = batch.dungeon;
+    GameHost host(hostOptions);
+    std::string error;
+    if (!host.start(error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    if (clients > 0) {
+        clientOptions.socketPath = hostSocket;
+        ClientReport clientReport = runHostClients(clientOptions);
+        host.stop();
+        printClientReport(std::cout, clientReport);
+    } else {
+        std::cout << "Hosting on " << hostSocket << " (Ctrl-C to stop)" << std::endl;
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        while (!stopRequested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        host.stop();
+    }
+    printHostReport(std::cout, host.report());
     return 0;
 }
+
+int runBatchMode(const std::string& scriptFile, const BatchOptions& base) {
+    BatchOptions options = base;
+    if (!loadBatchScripts(scriptFile, options.scripts)) {
+        std::cerr << "Could not open script file: " << scriptFile << "\n";
+        return 1;
+    }
+    if (options.scripts.empty()) {
+        std::cerr << "Script file has no commands: " << scriptFile << "\n";
+        return 1;
+    }
+
+    BatchReport report = runBatch(options);
+    if (!report.error.empty()) {
+        std::cerr << report.error << "\n";
+        return 1;
+    }
+
+    for (size_t i = 0; i < report.transcripts.size(); ++i) {
+        std::cout << "===== Session " << (i + 1) << " =====\n" << report.transcripts[i] << "\n";
+    }
+    printBatchReport(std::cout, report);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    StartupReport startup;
+    std::string batchScript;
+    BatchOptions batch;
+    batch.sessions = 1000;
+    GeneratorOptions generator;
+    bool generate = false;
+    bool generatorReport = false;
+    bool seeded = false;
+    std::string hostSocket;
+    std::string connectSocket;
+    size_t clients = 0;
+    std::string outputFile;
+    std::string metricsFile;
+    std::string journalFile;
+    std::string streamFile;
+    size_t residentChunks = 64;
+    CombatSimOptions combat;
+    bool combatSim = false;
+    bool startupReport = false;
+    ModuleSet modules = COMPILED_MODULES;
+    bool sessionLevel = false;
+    bool listModules = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--batch" && hasValue) {
+            batchScript = argv[++i];
+        } else if (arg == "--sessions" && hasValue) {
+            if (!parseCount(arg, argv[++i], batch.sessions)) {
+                return 1;
+            }
+        } else if (arg == "--threads" && hasValue) {
+            unsigned long long threads = 0;
+            if (!parseNumber(argv[++i], 0, UINT_MAX, threads)) {
+                std::cerr << "--threads needs a number of threads, or 0 for every core, not '"
+                          << argv[i] << "'\n";
+                return 1;
+            }
+            batch.threads = static_cast<unsigned>(threads);
+        } else if (arg == "--capture") {
+            batch.captureOutput = true;
+        } else if (arg == "--rooms" && hasValue) {
+            unsigned long long rooms = 0;
+            if (!parseNumber(argv[++i], GeneratorOptions::MIN_ROOMS, SIZE_MAX, rooms)) {
+                std::cerr << "--rooms needs at least " << GeneratorOptions::MIN_ROOMS
+                          << " rooms (an entrance and the boss's room), not '" << argv[i]
+                          << "'\n";
+                return 1;
+            }
+            if (rooms > GeneratorOptions::MAX_ROOMS) {
+                std::cerr << "--rooms needs at most " << GeneratorOptions::MAX_ROOMS
+                          << " rooms, not '" << argv[i] << "'\n";
+                return 1;
+            }
+            generator.rooms = static_cast<size_t>(rooms);
+            generate = true;
+        } else if (arg == "--seed" && hasValue) {
+            generator.seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (arg == "--stream-world" && hasValue) {
+            streamFile = argv[++i];
+        } else if (arg == "--resident-chunks" && hasValue) {
+            if (!parseCount(arg, argv[++i], residentChunks)) {
+                return 1;
+            }
+        } else if (arg == "--gen-report") {
+            generatorReport = true;
+            generate = true;
+        } else if (arg == "--startup-report") {
+            startupReport = true;
+        } else if (arg == "--type-report") {
+            std::cout << gameTypeReport();
+            return 0;
+        } else if (arg == "--combat-sim") {
+            combatSim = true;
+        } else if (arg == "--fights" && hasValue) {
+            if (!parseCount(arg, argv[++i], combat.fights)) {
+                return 1;
+            }
+        } else if (arg == "--scalar") {
+            combat.forceScalar = true;
+        } else if (arg == "--host" && hasValue) {
+            hostSocket = argv[++i];
+        } else if (arg == "--connect" && hasValue) {
+            connectSocket = argv[++i];
+        } else if (arg == "--clients" && hasValue) {
+            if (!parseCount(arg, argv[++i], clients)) {
+                return 1;
+            }
+        } else if (arg == "--output" && hasValue) {
+            outputFile = argv[++i];
+        } else if (arg == "--journal" && hasValue) {
+            journalFile = argv[++i];
+        } else if (arg == "--session-level" && hasValue) {
+            unsigned long long level = 0;
+            if (!parseNumber(argv[++i], 0, LAST_SESSION, level)) {
+                std::cerr << "--session-level needs a session number from 0 to " << LAST_SESSION
+                          << ", not '" << argv[i] << "'\n";
+                return 1;
+            }
+            modules = modulesUpTo(static_cast<int>(level));
+            sessionLevel = true;
+        } else if (arg == "--modules") {
+            listModules = true;
+#if CPP_QUEST_METRICS
+        } else if (arg == "--metrics" && hasValue) {
+            metricsFile = argv[++i];
+#endif
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (listModules) {
+        printModules(std::cout, modules);
+        return 0;
+    }
+
+    // Batch and host sessions each play their own in-memory copy of the world, and the
+    // combat simulator only reads its enemies and weapons
+    if (!streamFile.empty() &&
+        (!batchScript.empty() || !hostSocket.empty() || !connectSocket.empty() || combatSim)) {
+        std::cerr << "--stream-world only applies to interactive play; it can't be combined "
+                     "with --batch, --host, --connect or --combat-sim\n";
+        return 1;
+    }
+
+    // Batch sessions write their output to their report and keep no journal
+    if (!batchScript.empty() && (!outputFile.empty() || !journalFile.empty())) {
+        std::cerr << "--output and --journal only apply to interactive play; they can't be "
+                     "combined with --batch\n";
+        return 1;
+    }
+
+    // Batch and host sessions are built from the engine with every compiled module
+    if (sessionLevel && (!batchScript.empty() || !hostSocket.empty())) {
+        std::cerr << "--session-level only applies to interactive play and --combat-sim; it "
+                     "can't be combined with --batch or --host\n";
+        return 1;
+    }
+
+    startup.mark("arguments");
+
+    // Generation uses the same worker count and seed as batch runs
+    generator.threads = batch.threads;
+    batch.seed = generator.seed;
+    GeneratedDungeon dungeon;
+    if (generate) {
+        dungeon = generateDungeon(generator);
+        if (generatorReport) {
+            printGeneratorReport(std::cout, generator, dungeon);
+            return 0;
+        }
+        batch.dungeon = &dungeon;
+        startup.mark("generate dungeon");
+    }
+
+    if (!hostSocket.empty() || !connectSocket.empty()) {
+        return runHostMode(hostSocket, connectSocket, clients, batchScript, batch);
+    }
+
+    if (!batchScript.empty()) {
+        return runBatchMode(batchScript, batch);
+    }
+
+    if (combatSim) {
+        // The roster comes from the same modules as the rules
+        return withModules(modules, [&](auto config) {
+            constexpr ModuleSet MODULES = decltype(config)::MODULES;
+            BasicGameEngine<MODULES> roster;
+            if (generate) {
+                roster.loadDungeon(dungeon);
+            }
+            combat.seed = generator.seed;
+            printCombatReport(std::cout, engineCombatRules(MODULES), roster.combatRoster(),
+                              combat);
+            return 0;
+        });
+    }
+
+    // The engine writes one frame per turn straight to the descriptor, so the C++ streams
+    // don't need to stay synchronized with stdio
+    std::ios::sync_with_stdio(false);
+    FdSink stdoutSink(1);
+    std::unique_ptr<FileSink> fileSink;
+    if (!outputFile.empty()) {
+        fileSink = std::make_unique<FileSink>(outputFile);
+        if (!fileSink->isOpen()) {
+            std::cerr << "Could not open output file: " << outputFile << "\n";
+            return 1;
+        }
+    }
+
+    startup.mark("output");
+
+    // The selected modules are the engine's template argument: chosen once, here
+    return withModules(modules, [&](auto config) {
+        using Engine = BasicGameEngine<decltype(config)::MODULES>;
+        Engine game(std::cin, fileSink ? static_cast<OutputSink&>(*fileSink) : stdoutSink,
+                    &startup);
+        if (generate) {
+            game.loadDungeon(dungeon);
+            startup.mark("load dungeon");
+        }
+        std::string error;
+        if (!streamFile.empty()) {
+            if (!game.streamWorld(streamFile, residentChunks, error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+            dungeon = GeneratedDungeon();  // the game has its own copy, now on disk
+            startup.mark("stream world");
+        }
+        if (seeded) {
+            game.seedRandom(generator.seed);
+        }
+#if CPP_QUEST_METRICS
+        game.setMetricsPath(metricsFile);
+#endif
+
+        game.initialize(&startup);
+        if (!journalFile.empty()) {
+            if (!game.openJournal(journalFile, error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+            startup.mark("journal");
+        }
+        if (startupReport) {
+            game.prompt();
+            startup.mark("first prompt");
+            startup.print(std::cout);
+            return 0;
+        }
+        game.run();
+        game.shutdown();
+
+        return 0;
+    });
+}
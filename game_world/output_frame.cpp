@@ -0,0 +1,57 @@
+#include "output_frame.h"
+
+#include <cerrno>
+#include <ostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <unistd.h>
+#    define CPP_QUEST_HAS_POSIX_IO 1
+#else
+#    include <cstdio>
+#endif
+
+void FdSink::write(std::string_view frame) {
+#ifdef CPP_QUEST_HAS_POSIX_IO
+    // Loops only for short writes (pipes, signals); a frame is normally one call
+    while (!frame.empty() && fd_ >= 0) {
+        ++syscalls_;
+        ssize_t written = ::write(fd_, frame.data(), frame.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        frame.remove_prefix(static_cast<size_t>(written));
+    }
+#else
+    if (fd_ != 1 && fd_ != 2) {
+        return;
+    }
+    ++syscalls_;
+    std::fwrite(frame.data(), 1, frame.size(), fd_ == 2 ? stderr : stdout);
+    std::fflush(fd_ == 2 ? stderr : stdout);
+#endif
+}
+
+FileSink::FileSink(const std::string& path) {
+#ifdef CPP_QUEST_HAS_POSIX_IO
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#else
+    (void)path;
+#endif
+}
+
+FileSink::~FileSink() {
+#ifdef CPP_QUEST_HAS_POSIX_IO
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+void StreamSink::write(std::string_view frame) {
+    stream_.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    stream_.flush();
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Per-turn output frames
+ *
+ * The engine composes everything a turn prints into one reusable buffer
+ * (OutputFrame) and hands it to an OutputSink in a single write when the turn
+ * ends. Sinks decide where the bytes go: a file descriptor (the terminal), a
+ * file, a memory buffer, an existing std::ostream, or nowhere.
+ */
+
+class OutputSink {
+   public:
+    virtual ~OutputSink() = default;
+
+    // Called once per frame with the whole frame
+    virtual void write(std::string_view frame) = 0;
+};
+
+// Discards everything (headless runs that only need the outcome)
+class NullSink : public OutputSink {
+   public:
+    void write(std::string_view) override {}
+};
+
+// Appends to a string (captured transcripts, tests)
+class MemorySink : public OutputSink {
+   public:
+    void write(std::string_view frame) override { text_.append(frame); }
+
+    const std::string& text() const { return text_; }
+    std::string take() { return std::move(text_); }
+
+   private:
+    std::string text_;
+};
+
+// Writes to an open file descriptor with write(2); counts the system calls made
+class FdSink : public OutputSink {
+   public:
+    explicit FdSink(int fd) : fd_(fd) {}
+
+    void write(std::string_view frame) override;
+
+    size_t syscalls() const { return syscalls_; }
+
+   protected:
+    FdSink() = default;
+
+    int fd_ = -1;
+    size_t syscalls_ = 0;
+};
+
+// Creates (or truncates) a file and writes frames to it
+class FileSink : public FdSink {
+   public:
+    explicit FileSink(const std::string& path);
+    ~FileSink() override;
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    bool isOpen() const { return fd_ >= 0; }
+};
+
+// Writes each frame to a std::ostream and flushes it
+class StreamSink : public OutputSink {
+   public:
+    explicit StreamSink(std::ostream& stream) : stream_(stream) {}
+
+    void write(std::string_view frame) override;
+
+   private:
+    std::ostream& stream_;
+};
+
+class OutputFrame {
+   public:
+    explicit OutputFrame(OutputSink& sink) : sink_(&sink) { buffer_.reserve(INITIAL_CAPACITY); }
+    ~OutputFrame() { flush(); }
+    OutputFrame(const OutputFrame&) = delete;
+    OutputFrame& operator=(const OutputFrame&) = delete;
+
+    OutputFrame& operator<<(std::string_view text) {
+        buffer_.append(text);
+        return *this;
+    }
+
+    OutputFrame& operator<<(const char* text) { return *this << std::string_view(text); }
+    OutputFrame& operator<<(const std::string& text) { return *this << std::string_view(text); }
+
+    OutputFrame& operator<<(char c) {
+        buffer_.push_back(c);
+        return *this;
+    }
+
+    template <typename T,
+              std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> &&
+                                   !std::is_same_v<T, bool>,
+                               int> = 0>
+    OutputFrame& operator<<(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer_.append(digits, static_cast<size_t>(result.ptr - digits));
+        return *this;
+    }
+
+    // Hands the frame to the sink (one write) and starts a new one; keeps the capacity
+    void flush() {
+        if (buffer_.empty()) {
+            return;
+        }
+        sink_->write(buffer_);
+        bytes_ += buffer_.size();
+        ++frames_;
+        buffer_.clear();
+    }
+
+    // Drops the frame unwritten (used while replaying a journal)
+    void discard() { buffer_.clear(); }
+
+    size_t frames() const { return frames_; }
+    size_t bytes() const { return bytes_; }
+
+   private:
+    static constexpr size_t INITIAL_CAPACITY = 4096;
+
+    OutputSink* sink_;
+    std::string buffer_;
+    size_t frames_ = 0;
+    size_t bytes_ = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <stdlib.h>  // mkdtemp (POSIX)
+
+/**
+ * A temporary directory of this process's own
+ *
+ * create() makes a fresh directory under the system temp directory with
+ * mkdtemp(): a random name, mode 0700. Processes running at the same time
+ * never share files in it, and no other user can plant files or symlinks
+ * where the game is about to write. It is removed, with everything in it,
+ * by remove() or the destructor.
+ */
+class PrivateDir {
+   public:
+    PrivateDir() = default;
+    ~PrivateDir() { remove(); }
+    PrivateDir(const PrivateDir&) = delete;
+    PrivateDir& operator=(const PrivateDir&) = delete;
+
+    // False, with a message, if the directory can't be made
+    bool create(const std::string& prefix, std::string& error) {
+        remove();
+        std::error_code failed;
+        std::filesystem::path base = std::filesystem::temp_directory_path(failed);
+        if (failed) {
+            base = "/tmp";
+        }
+        std::string pattern = (base / (prefix + "XXXXXX")).string();
+        if (!mkdtemp(pattern.data())) {
+            error = "Could not create a directory in " + base.string() + ": " +
+                    std::strerror(errno);
+            return false;
+        }
+        path_ = pattern;
+        return true;
+    }
+
+    void remove() {
+        if (!path_.empty()) {
+            std::error_code ignored;
+            std::filesystem::remove_all(path_, ignored);
+            path_.clear();
+        }
+    }
+
+    // Empty until create() succeeds
+    const std::filesystem::path& path() const { return path_; }
+
+   private:
+    std::filesystem::path path_;
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Quest event bus
+ *
+ * Game events (an enemy defeated, an item looted, a room entered) are
+ * published with a 32-bit subject: the enemy's name id, the item id or the
+ * room's name id. A quest subscribes to one (event, subject) key and
+ * completes after a number of matching events.
+ *
+ * Subscriptions are kept in one array grouped by key, with an open-addressing
+ * table from key to its group, so publishing is a hash probe plus a walk over
+ * the quests still waiting on that key. Completed quests are swapped out of
+ * the live part of their group and never visited again. The index is rebuilt
+ * only when quests are added or re-subscribed; publishing never allocates.
+ */
+
+enum class GameEvent : uint8_t { EnemyDefeated, ItemLooted, RoomEntered };
+
+class QuestBus {
+   public:
+    using QuestId = uint32_t;
+    // Subject that no event carries; a quest subscribed to it waits forever
+    static constexpr uint32_t NO_SUBJECT = ~uint32_t{0};
+
+    QuestId add(GameEvent event, uint32_t subject, uint32_t needed = 1) {
+        quests_.push_back({event, subject, needed, 0});
+        dirty_ = true;
+        return static_cast<QuestId>(quests_.size() - 1);
+    }
+
+    // Points a quest at another subject, e.g. when a new world interns its names differently
+    void subscribe(QuestId quest, uint32_t subject) {
+        quests_[quest].subject = subject;
+        dirty_ = true;
+    }
+
+    void clear() { *this = QuestBus(); }
+
+    size_t size() const { return quests_.size(); }
+    size_t completedCount() const { return completed_; }
+    bool completed(QuestId quest) const { return done(quests_[quest]); }
+    GameEvent event(QuestId quest) const { return quests_[quest].event; }
+    uint32_t progress(QuestId quest) const { return quests_[quest].progress; }
+
+    // Calls onComplete(QuestId) for each quest this event completes
+    template <typename Fn>
+    void publish(GameEvent event, uint32_t subject, Fn&& onComplete) {
+        if (dirty_) {
+            rebuild();
+        }
+        Group* group = find(keyOf(event, subject));
+        if (!group) {
+            return;
+        }
+        for (uint32_t i = group->begin; i < group->begin + group->live;) {
+            QuestId id = subscribers_[i];
+            Quest& quest = quests_[id];
+            if (++quest.progress < quest.needed) {
+                ++i;
+                continue;
+            }
+            ++completed_;
+            --group->live;
+            subscribers_[i] = subscribers_[group->begin + group->live];
+            subscribers_[group->begin + group->live] = id;
+            onComplete(id);
+        }
+    }
+
+    // Progress of every quest, in id order (for snapshots)
+    std::vector<uint32_t> progressColumn() const {
+        std::vector<uint32_t> column(quests_.size());
+        for (size_t q = 0; q < quests_.size(); ++q) {
+            column[q] = quests_[q].progress;
+        }
+        return column;
+    }
+
+    // False if the column was saved with a different set of quests
+    bool restoreProgress(const std::vector<uint32_t>& column) {
+        if (column.size() != quests_.size()) {
+            return false;
+        }
+        completed_ = 0;
+        for (size_t q = 0; q < quests_.size(); ++q) {
+            quests_[q].progress = column[q];
+            completed_ += done(quests_[q]);
+        }
+        dirty_ = true;
+        return true;
+    }
+
+   private:
+    struct Quest {
+        GameEvent event;
+        uint32_t subject;
+        uint32_t needed;
+        uint32_t progress;
+    };
+
+    // subscribers_[begin, begin + live) wait on key; the rest of the group are done
+    struct Group {
+        uint64_t key;
+        uint32_t begin;
+        uint32_t live;
+    };
+
+    static constexpr uint64_t EMPTY = ~uint64_t{0};
+
+    static bool done(const Quest& quest) { return quest.progress >= quest.needed; }
+
+    static uint64_t keyOf(GameEvent event, uint32_t subject) {
+        return (static_cast<uint64_t>(event) << 32) | subject;
+    }
+
+    static size_t hash(uint64_t key) {
+        key ^= key >> 29;
+        key *= 0xBF58476D1CE4E5B9ull;
+        return static_cast<size_t>(key ^ (key >> 32));
+    }
+
+    // The key's group, or the empty slot where it would go (linear probing)
+    size_t slotOf(uint64_t key) const {
+        size_t mask = groups_.size() - 1;
+        size_t slot = hash(key) & mask;
+        while (groups_[slot].key != EMPTY && groups_[slot].key != key) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    Group* find(uint64_t key) {
+        if (groups_.empty()) {
+            return nullptr;
+        }
+        Group& group = groups_[slotOf(key)];
+        return group.key == key ? &group : nullptr;
+    }
+
+    // Counting sort of the quests still waiting into per-key groups
+    void rebuild() {
+        dirty_ = false;
+        size_t capacity = 16;
+        while (capacity * 3 < quests_.size() * 4) {
+            capacity *= 2;
+        }
+        groups_.assign(capacity, {EMPTY, 0, 0});
+
+        for (const Quest& quest : quests_) {
+            if (!done(quest)) {
+                Group& group = groups_[slotOf(keyOf(quest.event, quest.subject))];
+                group.key = keyOf(quest.event, quest.subject);
+                ++group.live;
+            }
+        }
+        uint32_t begin = 0;
+        for (Group& group : groups_) {
+            group.begin = begin;
+            begin += group.live;
+            group.live = 0;
+        }
+        subscribers_.resize(begin);
+        for (QuestId id = 0; id < quests_.size(); ++id) {
+            const Quest& quest = quests_[id];
+            if (!done(quest)) {
+                Group& group = groups_[slotOf(keyOf(quest.event, quest.subject))];
+                subscribers_[group.begin + group.live++] = id;
+            }
+        }
+    }
+
+    std::vector<Quest> quests_;
+    std::vector<Group> groups_;         // power-of-two size, at most 3/4 full
+    std::vector<QuestId> subscribers_;  // quest ids grouped by key
+    size_t completed_ = 0;
+    bool dirty_ = false;
+};
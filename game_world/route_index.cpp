@@ -0,0 +1,272 @@
+#include "route_index.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace {
+
+// Heap key: lowest estimate first, and among equal estimates the room farthest along (fewer
+// rooms are opened when the search commits to one route). The cost is recoverable from the
+// key, which is how stale heap entries are recognised.
+uint64_t heapKey(uint32_t estimate, uint32_t cost) {
+    return (static_cast<uint64_t>(estimate) << 32) | (RouteIndex::UNREACHABLE - cost);
+}
+
+uint32_t costOf(uint64_t key) {
+    return RouteIndex::UNREACHABLE - static_cast<uint32_t>(key);
+}
+
+}  // namespace
+
+size_t RouteGraph::memoryBytes() const {
+    return component.capacity() * sizeof(RoomId) + exits.capacity() * sizeof(exits[0]) +
+           landmarkDistance.capacity() * sizeof(uint16_t);
+}
+
+void RouteIndex::build(const WorldStore& world) {
+    auto built = std::make_shared<RouteGraph>();
+    RouteGraph& graph = *built;
+    size_t rooms = world.roomCount();
+    graph.component.resize(rooms);
+    std::iota(graph.component.begin(), graph.component.end(), RoomId{0});
+    graph.exits.resize(rooms);
+    for (size_t room = 0; room < rooms; ++room) {
+        graph.exits[room] = world.exits(static_cast<RoomId>(room));
+        for (RoomId next : graph.exits[room]) {
+            if (next != WorldStore::NO_ROOM) {
+                join(graph, static_cast<RoomId>(room), next);
+            }
+        }
+    }
+    // Every room links straight to its root, so lookups on a shared graph never write
+    for (size_t room = 0; room < rooms; ++room) {
+        graph.component[room] = graph.root(static_cast<RoomId>(room));
+    }
+
+    // Farthest-point landmarks: start at the far end of the map from the entrance, then keep
+    // adding the room farthest from every landmark so far
+    graph.landmarkCount = std::min(LANDMARKS, rooms);
+    graph.landmarkDistance.assign(rooms * LANDMARKS, FAR);
+    if (graph.landmarkCount > 0) {
+        std::vector<uint32_t> nearest(rooms, UNREACHABLE);
+        RoomId next = distancesFrom(graph, 0, distance_);
+        for (size_t i = 0; i < graph.landmarkCount; ++i) {
+            graph.landmarks[i] = next;
+            distancesFrom(graph, next, distance_);
+            uint32_t farthest = 0;
+            for (size_t room = 0; room < rooms; ++room) {
+                uint32_t dist = distance_[room];
+                graph.distance(static_cast<RoomId>(room), i) =
+                    static_cast<uint16_t>(std::min<uint32_t>(dist, FAR));
+                nearest[room] = std::min(nearest[room], dist);
+                if (nearest[room] != UNREACHABLE && nearest[room] > farthest) {
+                    farthest = nearest[room];
+                    next = static_cast<RoomId>(room);
+                }
+            }
+        }
+    }
+    std::vector<uint32_t>().swap(distance_);
+    ownGraph_ = std::move(built);
+    graph_ = ownGraph_;
+}
+
+void RouteIndex::exitAdded(const WorldStore& world, RoomId from, RoomId to) {
+    if (!graph_) {
+        return;
+    }
+    if (graph_->component.size() != world.roomCount()) {
+        invalidate();  // rooms were added as well; cheaper to start over
+        return;
+    }
+    RouteGraph& graph = editGraph();
+    graph.exits[from] = world.exits(from);
+    join(graph, from, to);
+
+    // Distances can only shrink: relax outward from `to` while they do (FAR + 1 never does)
+    for (size_t i = 0; i < graph.landmarkCount; ++i) {
+        uint32_t reach = graph.distance(from, i) + 1u;
+        if (reach >= graph.distance(to, i)) {
+            continue;
+        }
+        graph.distance(to, i) = static_cast<uint16_t>(reach);
+        queue_.assign(1, to);
+        for (size_t head = 0; head < queue_.size(); ++head) {
+            RoomId room = queue_[head];
+            uint32_t step = graph.distance(room, i) + 1u;
+            for (RoomId next : graph.exits[room]) {
+                if (next != WorldStore::NO_ROOM && step < graph.distance(next, i)) {
+                    graph.distance(next, i) = static_cast<uint16_t>(step);
+                    queue_.push_back(next);
+                }
+            }
+        }
+    }
+}
+
+bool RouteIndex::connected(const WorldStore& world, RoomId a, RoomId b) {
+    ensureBuilt(world);
+    return graph_->root(a) == graph_->root(b);
+}
+
+bool RouteIndex::route(const WorldStore& world, RoomId from, RoomId to,
+                       std::vector<RoomId>& path) {
+    ensureBuilt(world);
+    path.clear();
+    visited_ = 0;
+    if (from == to) {
+        return true;
+    }
+    const RouteGraph& graph = *graph_;
+    if (graph.root(from) != graph.root(to)) {
+        return false;
+    }
+
+    chooseLandmarks(from, to);
+    beginQuery(world.roomCount());
+    see(from, 0, WorldStore::NO_ROOM);
+    heap_.clear();
+    heap_.emplace_back(heapKey(lowerBound(from, to), 0), from);
+    auto later = std::greater<std::pair<uint64_t, RoomId>>();
+
+    while (!heap_.empty()) {
+        std::pop_heap(heap_.begin(), heap_.end(), later);
+        auto [key, room] = heap_.back();
+        heap_.pop_back();
+        uint32_t cost = costOf(key);
+        if (cost != cost_[room]) {
+            continue;  // reached more cheaply since this entry was pushed
+        }
+        ++visited_;
+        if (room == to) {
+            tracePath(from, to, path);
+            return true;
+        }
+        for (RoomId next : graph.exits[room]) {
+            if (next == WorldStore::NO_ROOM || (seen(next) && cost_[next] <= cost + 1)) {
+                continue;
+            }
+            see(next, cost + 1, room);
+            heap_.emplace_back(heapKey(cost + 1 + lowerBound(next, to), cost + 1), next);
+            std::push_heap(heap_.begin(), heap_.end(), later);
+        }
+    }
+    return false;
+}
+
+RouteIndex::RoomId RouteIndex::routeToName(const WorldStore& world, RoomId from,
+                                           uint32_t nameId, std::vector<RoomId>& path) {
+    ensureBuilt(world);
+    path.clear();
+    visited_ = 0;
+
+    // Breadth-first, so the first room found with the name is a closest one
+    const RouteGraph& graph = *graph_;
+    beginQuery(world.roomCount());
+    see(from, 0, WorldStore::NO_ROOM);
+    queue_.assign(1, from);
+    for (size_t head = 0; head < queue_.size(); ++head) {
+        RoomId room = queue_[head];
+        ++visited_;
+        if (world.nameId(room) == nameId) {
+            tracePath(from, room, path);
+            return room;
+        }
+        for (RoomId next : graph.exits[room]) {
+            if (next != WorldStore::NO_ROOM && !seen(next)) {
+                see(next, cost_[room] + 1, room);
+                queue_.push_back(next);
+            }
+        }
+    }
+    return WorldStore::NO_ROOM;
+}
+
+size_t RouteIndex::memoryBytes() const {
+    return (graph_ ? graph_->memoryBytes() : 0) + stamp_.capacity() * sizeof(uint32_t) +
+           cost_.capacity() * sizeof(uint32_t) + parent_.capacity() * sizeof(RoomId) +
+           queue_.capacity() * sizeof(RoomId) + heap_.capacity() * sizeof(heap_[0]);
+}
+
+RouteIndex::RoomId RouteIndex::distancesFrom(const RouteGraph& graph, RoomId source,
+                                             std::vector<uint32_t>& dist) {
+    dist.assign(graph.exits.size(), UNREACHABLE);
+    dist[source] = 0;
+    queue_.assign(1, source);
+    for (size_t head = 0; head < queue_.size(); ++head) {
+        RoomId room = queue_[head];
+        for (RoomId next : graph.exits[room]) {
+            if (next != WorldStore::NO_ROOM && dist[next] == UNREACHABLE) {
+                dist[next] = dist[room] + 1;
+                queue_.push_back(next);
+            }
+        }
+    }
+    return queue_.back();
+}
+
+void RouteIndex::join(RouteGraph& graph, RoomId a, RoomId b) {
+    // Path halving on the way up keeps the trees flat as exits are added
+    for (RoomId* room : {&a, &b}) {
+        while (graph.component[*room] != *room) {
+            graph.component[*room] = graph.component[graph.component[*room]];
+            *room = graph.component[*room];
+        }
+    }
+    if (a != b) {
+        graph.component[std::max(a, b)] = std::min(a, b);
+    }
+}
+
+void RouteIndex::chooseLandmarks(RoomId from, RoomId to) {
+    // Each landmark's bound on the whole route; the tightest ones keep being the tightest along it
+    std::array<std::pair<uint32_t, uint8_t>, LANDMARKS> bounds{};
+    const RouteGraph& graph = *graph_;
+    for (size_t i = 0; i < graph.landmarkCount; ++i) {
+        uint32_t toTarget = graph.distance(to, i);
+        uint32_t toFrom = graph.distance(from, i);
+        uint32_t bound = toTarget != FAR && toFrom < toTarget ? toTarget - toFrom : 0;
+        bounds[i] = {bound, static_cast<uint8_t>(i)};
+    }
+    activeCount_ = std::min(ACTIVE_LANDMARKS, graph.landmarkCount);
+    std::partial_sort(bounds.begin(), bounds.begin() + activeCount_,
+                      bounds.begin() + graph.landmarkCount, std::greater<>());
+    for (size_t a = 0; a < activeCount_; ++a) {
+        active_[a] = bounds[a].second;
+    }
+}
+
+uint32_t RouteIndex::lowerBound(RoomId room, RoomId to) const {
+    const uint16_t* roomRow = &graph_->landmarkDistance[static_cast<size_t>(room) * LANDMARKS];
+    const uint16_t* targetRow = &graph_->landmarkDistance[static_cast<size_t>(to) * LANDMARKS];
+    uint32_t bound = 0;
+    for (size_t a = 0; a < activeCount_; ++a) {
+        uint32_t toTarget = targetRow[active_[a]];
+        uint32_t toRoom = roomRow[active_[a]];
+        if (toTarget != FAR && toRoom < toTarget) {
+            bound = std::max(bound, toTarget - toRoom);
+        }
+    }
+    return bound;
+}
+
+void RouteIndex::beginQuery(size_t rooms) {
+    if (stamp_.size() != rooms) {
+        stamp_.assign(rooms, 0);
+        cost_.resize(rooms);
+        parent_.resize(rooms);
+        query_ = 0;
+    }
+    if (++query_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        query_ = 1;
+    }
+}
+
+void RouteIndex::tracePath(RoomId from, RoomId to, std::vector<RoomId>& path) const {
+    for (RoomId room = to; room != from; room = parent_[room]) {
+        path.push_back(room);
+    }
+    std::reverse(path.begin(), path.end());
+}
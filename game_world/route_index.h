@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "world_store.h"
+
+/**
+ * Routing over the dungeon's exit graph
+ *
+ * Built once per world layout, on the first query, from a copy of the exits
+ * (so searches never page a streamed world's chunks in search order). The
+ * built RouteGraph is immutable and cached in the layout: every copy of a
+ * world (every game in a batch run or on a host) shares one, and each
+ * RouteIndex keeps only its query scratch.
+ *
+ *   components  a union-find forest over the exits (taken as two-way), so
+ *               rooms in different parts of the map are known to be
+ *               unreachable without searching
+ *   landmarks   16 rooms spread far apart, with the distance from each to
+ *               every room (stored room by room, so one room's distances
+ *               share a cache line). By the triangle inequality,
+ *               dist(L, to) - dist(L, room) never overestimates
+ *               dist(room, to), which steers an A* search toward the
+ *               target (ALT); each query uses the few landmarks that bound
+ *               its start-to-target distance best
+ *
+ * Per-query scratch arrays are stamped rather than cleared, so a query costs
+ * what it visits, not the size of the world: nearby rooms are microseconds
+ * away, and a route across a 10^6-room maze visits a few percent of it.
+ *
+ * Adding an exit updates the index in place (distances only shrink and
+ * components only merge), on a copy of the graph of its own if it was shared.
+ * Removing or redirecting one can make distances grow, so it drops the index
+ * and the next query rebuilds it.
+ */
+
+// What a RouteIndex builds from a world's exits
+struct RouteGraph {
+    using RoomId = WorldStore::RoomId;
+    static constexpr size_t LANDMARKS = 16;
+    // Landmark distances at or past this are stored as FAR (unreachable or too far to store)
+    static constexpr uint16_t FAR = 0xFFFF;
+
+    std::vector<RoomId> component;  // union-find parent links
+    std::vector<std::array<RoomId, WorldStore::EXIT_SLOTS>> exits;
+    size_t landmarkCount = 0;
+    std::array<RoomId, LANDMARKS> landmarks{};
+    // Distances from each landmark, LANDMARKS per room
+    std::vector<uint16_t> landmarkDistance;
+
+    RoomId root(RoomId room) const {
+        while (component[room] != room) {
+            room = component[room];
+        }
+        return room;
+    }
+
+    uint16_t distance(RoomId room, size_t landmark) const {
+        return landmarkDistance[static_cast<size_t>(room) * LANDMARKS + landmark];
+    }
+    uint16_t& distance(RoomId room, size_t landmark) {
+        return landmarkDistance[static_cast<size_t>(room) * LANDMARKS + landmark];
+    }
+
+    size_t memoryBytes() const;
+};
+
+class RouteIndex {
+   public:
+    using RoomId = WorldStore::RoomId;
+    static constexpr size_t LANDMARKS = RouteGraph::LANDMARKS;
+    static constexpr size_t ACTIVE_LANDMARKS = 4;
+    static constexpr uint32_t UNREACHABLE = ~uint32_t{0};
+
+    void invalidate() {
+        graph_.reset();
+        ownGraph_.reset();
+    }
+    bool built() const { return graph_ != nullptr; }
+    // Builds a graph of this index's own from world, whatever the world has cached
+    void build(const WorldStore& world);
+    // True if the graph is shared with other indexes through the world's layout
+    bool shared() const { return graph_ && !ownGraph_; }
+
+    // Call after world.setExit(from, direction, to) added an exit
+    void exitAdded(const WorldStore& world, RoomId from, RoomId to);
+    // Call after an exit was removed or pointed elsewhere
+    void exitRemoved() { invalidate(); }
+
+    // Same connected part of the map (necessary for a route, and sufficient when exits are
+    // two-way, as in every dungeon the game builds)
+    bool connected(const WorldStore& world, RoomId a, RoomId b);
+
+    // Fills path with the rooms after from, up to and including to; false if there is no route
+    bool route(const WorldStore& world, RoomId from, RoomId to, std::vector<RoomId>& path);
+
+    // Route to the closest room with this name id; returns that room, or NO_ROOM
+    RoomId routeToName(const WorldStore& world, RoomId from, uint32_t nameId,
+                       std::vector<RoomId>& path);
+
+    // Rooms the last query took off its frontier
+    size_t lastVisited() const { return visited_; }
+
+    // The graph (shared or not) and this index's scratch
+    size_t memoryBytes() const;
+
+   private:
+    static constexpr uint16_t FAR = RouteGraph::FAR;
+
+    // Takes the graph cached for the world's layout, or builds and caches one
+    void ensureBuilt(const WorldStore& world) {
+        if (graph_ && graph_->component.size() == world.roomCount()) {
+            return;
+        }
+        invalidate();
+        graph_ = world.cachedRoutes();
+        if (!graph_ || graph_->component.size() != world.roomCount()) {
+            build(world);
+            world.cacheRoutes(graph_);
+            ownGraph_.reset();
+        }
+    }
+
+    // The graph to change, copied first if it is shared
+    RouteGraph& editGraph() {
+        if (!ownGraph_) {
+            ownGraph_ = std::make_shared<RouteGraph>(*graph_);
+            graph_ = ownGraph_;
+        }
+        return *ownGraph_;
+    }
+
+    // Breadth-first distances from source over the graph's exits; returns the farthest room
+    // reached
+    RoomId distancesFrom(const RouteGraph& graph, RoomId source, std::vector<uint32_t>& dist);
+    static void join(RouteGraph& graph, RoomId a, RoomId b);
+
+    // Picks the landmarks lowerBound() consults for routes to `to`
+    void chooseLandmarks(RoomId from, RoomId to);
+    uint32_t lowerBound(RoomId room, RoomId to) const;
+
+    // Starts a query: rooms whose stamp differs from query_ count as unseen
+    void beginQuery(size_t rooms);
+    bool seen(RoomId room) const { return stamp_[room] == query_; }
+    void see(RoomId room, uint32_t cost, RoomId parent) {
+        stamp_[room] = query_;
+        cost_[room] = cost;
+        parent_[room] = parent;
+    }
+    void tracePath(RoomId from, RoomId to, std::vector<RoomId>& path) const;
+
+    // Null until built; ownGraph_ is set too when the graph is this index's alone
+    std::shared_ptr<const RouteGraph> graph_;
+    std::shared_ptr<RouteGraph> ownGraph_;
+    std::array<uint8_t, ACTIVE_LANDMARKS> active_{};
+    size_t activeCount_ = 0;
+    std::vector<uint32_t> distance_;  // breadth-first scratch while building
+
+    // Query scratch, sized to the world and reused
+    std::vector<uint32_t> stamp_;
+    std::vector<uint32_t> cost_;
+    std::vector<RoomId> parent_;
+    std::vector<RoomId> queue_;
+    std::vector<std::pair<uint64_t, RoomId>> heap_;
+    uint32_t query_ = 0;
+    size_t visited_ = 0;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+/**
+ * Registry of the session modules the engine can play with
+ *
+ * Each module is one session's subsystem (Session 2's inventory, Session 8's
+ * combat, ...). Every module whose session is on disk is compiled in
+ * (COMPILED_MODULES); which of them a game uses is chosen at startup, as a
+ * session level: the modules of every session up to it, the way the course
+ * adds them.
+ *
+ * The engine is a template over its ModuleSet and tests it with
+ * `if constexpr`, so a game pays nothing per call for the choice.
+ * withModules() turns the runtime choice into that template argument once;
+ * there is one engine instantiation per level, not one per subset.
+ */
+
+enum class Module : uint8_t { Inventory, SaveLoad, Weapons, Spells, Combat, Quests };
+
+inline constexpr size_t MODULE_COUNT = static_cast<size_t>(Module::Quests) + 1;
+
+// A set of modules; usable as a template argument
+struct ModuleSet {
+    uint8_t bits = 0;
+
+    constexpr bool has(Module module) const { return (bits >> static_cast<int>(module)) & 1; }
+    constexpr ModuleSet with(Module module) const {
+        return {static_cast<uint8_t>(bits | (1u << static_cast<int>(module)))};
+    }
+    constexpr bool operator==(const ModuleSet&) const = default;
+};
+
+struct ModuleInfo {
+    Module module;
+    int session;
+    std::string_view name;
+    std::string_view description;  // as the banner lists it
+};
+
+// In session order
+inline constexpr ModuleInfo SESSION_MODULES[MODULE_COUNT] = {
+    {Module::Inventory, 2, "inventory", "Inventory system (dynamic memory)"},
+    {Module::SaveLoad, 3, "saveload", "Save/Load system (file I/O)"},
+    {Module::Weapons, 4, "weapons", "Weapon system (smart pointers)"},
+    {Module::Spells, 5, "spells", "Spell system (classes)"},
+    {Module::Combat, 8, "combat", "Combat system (polymorphism)"},
+    {Module::Quests, 11, "quests", "Quest system (STL containers)"},
+};
+
+// Modules whose session's starter code is in the build
+inline constexpr ModuleSet COMPILED_MODULES = ModuleSet{}
+#ifdef SESSION_02_AVAILABLE
+    .with(Module::Inventory)
+#endif
+#ifdef SESSION_03_AVAILABLE
+    .with(Module::SaveLoad)
+#endif
+#ifdef SESSION_04_AVAILABLE
+    .with(Module::Weapons)
+#endif
+#ifdef SESSION_05_AVAILABLE
+    .with(Module::Spells)
+#endif
+#ifdef SESSION_08_AVAILABLE
+    .with(Module::Combat)
+#endif
+#ifdef SESSION_11_AVAILABLE
+    .with(Module::Quests)
+#endif
+    ;
+
+// The compiled modules of sessions up to session
+constexpr ModuleSet modulesUpTo(int session) {
+    ModuleSet modules;
+    for (const ModuleInfo& info : SESSION_MODULES) {
+        if (info.session <= session && COMPILED_MODULES.has(info.module)) {
+            modules = modules.with(info.module);
+        }
+    }
+    return modules;
+}
+
+// False for a session whose module is compiled in but not selected; true otherwise
+constexpr bool sessionSelected(ModuleSet modules, int session) {
+    for (const ModuleInfo& info : SESSION_MODULES) {
+        if (info.session == session) {
+            return modules.has(info.module);
+        }
+    }
+    return true;
+}
+
+// Names a module set as a template argument
+template <ModuleSet Modules>
+struct ModuleConfig {
+    static constexpr ModuleSet MODULES = Modules;
+};
+
+// Calls fn(ModuleConfig<modules>{}); modules must be modulesUpTo() of some level. Sets that
+// aren't fall back to every compiled module.
+template <size_t I = 0, typename Fn>
+decltype(auto) withModules(ModuleSet modules, Fn&& fn) {
+    if constexpr (I == MODULE_COUNT) {
+        return fn(ModuleConfig<COMPILED_MODULES>{});
+    } else {
+        constexpr ModuleSet before = modulesUpTo(SESSION_MODULES[I].session - 1);
+        if (modules == before) {
+            return fn(ModuleConfig<before>{});
+        }
+        return withModules<I + 1>(modules, static_cast<Fn&&>(fn));
+    }
+}
+
+// The registry, one module per line, marking those compiled in and those in modules
+inline void printModules(std::ostream& out, ModuleSet modules) {
+    out << "Session modules (compiled in: *, selected: +)\n";
+    for (const ModuleInfo& info : SESSION_MODULES) {
+        out << "  " << (COMPILED_MODULES.has(info.module) ? '*' : ' ')
+            << (modules.has(info.module) ? '+' : ' ') << " Session " << info.session
+            << (info.session < 10 ? "  " : " ") << info.name;
+        for (size_t column = info.name.size(); column < 11; ++column) {
+            out << ' ';
+        }
+        out << info.description << "\n";
+    }
+}
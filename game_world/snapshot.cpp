@@ -0,0 +1,168 @@
+#include "snapshot.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define CPP_QUEST_HAS_MMAP 1
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = {'C', 'Q', 'S', 'V'};
+constexpr uint32_t VERSION = 5;
+// Reads back differently on a machine with the other byte order
+constexpr uint32_t BYTE_ORDER_TAG = 0x01020304;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t payloadSize;
+    uint64_t checksum;
+};
+
+}  // namespace
+
+uint64_t snapshotChecksum(const char* data, size_t size) {
+    // FNV-1a over 64-bit words with an extra shift, then the tail bytes
+    const uint64_t prime = 0x100000001B3ull;
+    uint64_t hash = 0xCBF29CE484222325ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return hash;
+}
+
+size_t SnapshotWriter::writeFile(const std::string& path) const {
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_TAG;
+    header.payloadSize = payload_.size();
+    header.checksum = snapshotChecksum(payload_.data(), payload_.size());
+
+    // Written beside the old snapshot and renamed over it: a crash or a full disk leaves the
+    // old one whole, and a SnapshotFile still mapping it keeps reading the old bytes
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return 0;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(payload_.data(), static_cast<std::streamsize>(payload_.size()));
+    file.close();
+    std::error_code error;
+    if (file) {
+        std::filesystem::rename(temporary, path, error);
+    }
+    if (!file || error) {
+        std::filesystem::remove(temporary, error);
+        return 0;
+    }
+    return sizeof(header) + payload_.size();
+}
+
+SnapshotFile::~SnapshotFile() { close(); }
+
+void SnapshotFile::close() {
+#ifdef CPP_QUEST_HAS_MMAP
+    if (mapping_) {
+        munmap(mapping_, mappedSize_);
+    }
+#endif
+    mapping_ = nullptr;
+    mappedSize_ = 0;
+    fallback_.clear();
+    payload_ = nullptr;
+    payloadSize_ = 0;
+}
+
+SnapshotStatus SnapshotFile::open(const std::string& path) {
+    close();
+    error_.clear();
+    // A save that is there but can't be read isn't reported as no save
+    auto unreadable = [&](int failure) {
+        if (failure == ENOENT) {
+            return SnapshotStatus::Missing;
+        }
+        error_ = path + ": " + std::strerror(failure);
+        return SnapshotStatus::Unreadable;
+    };
+
+    const char* bytes = nullptr;
+#ifdef CPP_QUEST_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return unreadable(errno);
+    }
+    struct stat info {};
+    int failure = 0;
+    if (fstat(fd, &info) != 0) {
+        failure = errno;
+    } else if (!S_ISREG(info.st_mode)) {
+        failure = S_ISDIR(info.st_mode) ? EISDIR : EINVAL;
+    }
+    if (failure != 0) {
+        ::close(fd);
+        return unreadable(failure);
+    }
+    if (info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return SnapshotStatus::Corrupt;
+    }
+    mappedSize_ = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mappedSize_ = 0;
+        return SnapshotStatus::Corrupt;
+    }
+    mapping_ = mapping;
+    bytes = static_cast<const char*>(mapping);
+#else
+    errno = 0;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return unreadable(errno != 0 ? errno : ENOENT);
+    }
+    fallback_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    mappedSize_ = fallback_.size();
+    if (mappedSize_ < sizeof(Header)) {
+        return SnapshotStatus::Corrupt;
+    }
+    bytes = fallback_.data();
+#endif
+
+    Header header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.byteOrder != BYTE_ORDER_TAG ||
+        header.payloadSize != mappedSize_ - sizeof(Header)) {
+        return SnapshotStatus::Corrupt;
+    }
+
+    const char* payload = bytes + sizeof(Header);
+    if (snapshotChecksum(payload, header.payloadSize) != header.checksum) {
+        return SnapshotStatus::Corrupt;
+    }
+
+    payload_ = payload;
+    payloadSize_ = header.payloadSize;
+    return SnapshotStatus::Ok;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Versioned binary snapshot files
+ *
+ * Layout: a fixed header (magic, version, byte-order tag, payload size and
+ * checksum) followed by the payload. The payload is a flat sequence of
+ * fixed-size values, length-prefixed strings and length-prefixed columns
+ * (raw arrays), each padded to 8 bytes. Columns are written and read with a
+ * single memcpy, so large worlds load at memory bandwidth.
+ *
+ * Files are loaded through a read-only memory mapping; the header and
+ * checksum are validated before any field is read.
+ */
+
+class SnapshotWriter {
+   public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        append(&value, sizeof(T));
+    }
+
+    void putString(std::string_view text) {
+        put<uint64_t>(text.size());
+        append(text.data(), text.size());
+    }
+
+    template <typename T>
+    void putColumn(const std::vector<T>& column) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        put<uint64_t>(column.size());
+        append(column.data(), column.size() * sizeof(T));
+    }
+
+    // A column of count values that fill(T* values) writes in place, for sources that are
+    // not one contiguous array
+    template <typename T, typename Fill>
+    void putColumn(size_t count, Fill&& fill) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        put<uint64_t>(count);
+        size_t at = payload_.size();
+        payload_.resize(at + ((count * sizeof(T) + 7) & ~size_t{7}), 0);
+        fill(reinterpret_cast<T*>(payload_.data() + at));
+    }
+
+    size_t size() const { return payload_.size(); }
+    const char* data() const { return payload_.data(); }
+
+    // Replaces path with header + payload; returns bytes written, or 0 on failure (the old
+    // file, if any, is left as it was)
+    size_t writeFile(const std::string& path) const;
+
+   private:
+    void append(const void* data, size_t size) {
+        size_t at = payload_.size();
+        size_t padded = (size + 7) & ~size_t{7};
+        payload_.resize(at + padded, 0);
+        if (size > 0) {
+            std::memcpy(payload_.data() + at, data, size);
+        }
+    }
+
+    std::vector<char> payload_;
+};
+
+class SnapshotReader {
+   public:
+    SnapshotReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return take(&value, sizeof(T));
+    }
+
+    bool getString(std::string& text) {
+        uint64_t length = 0;
+        if (!get(length) || length > remaining()) {
+            return false;
+        }
+        text.assign(data_ + offset_, length);
+        return skip(length);
+    }
+
+    template <typename T>
+    bool getColumn(std::vector<T>& column) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint64_t count = 0;
+        if (!get(count) || count > remaining() / sizeof(T)) {
+            return false;
+        }
+        column.resize(count);
+        return take(column.data(), count * sizeof(T));
+    }
+
+    bool atEnd() const { return offset_ == size_; }
+
+   private:
+    size_t remaining() const { return size_ - offset_; }
+
+    bool take(void* out, size_t size) {
+        if (size > remaining()) {
+            return false;
+        }
+        if (size > 0) {
+            std::memcpy(out, data_ + offset_, size);
+        }
+        return skip(size);
+    }
+
+    bool skip(size_t size) {
+        size_t padded = (size + 7) & ~size_t{7};
+        offset_ += padded < remaining() ? padded : remaining();
+        return true;
+    }
+
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+// Missing only when no file exists at the path; Unreadable when one does but can't be read
+enum class SnapshotStatus { Ok, Missing, Unreadable, Corrupt };
+
+/**
+ * A snapshot file mapped into memory. Only valid while the object lives.
+ */
+class SnapshotFile {
+   public:
+    SnapshotFile() = default;
+    ~SnapshotFile();
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    SnapshotStatus open(const std::string& path);
+    // Why the last open() returned Unreadable: the path and the system's reason
+    const std::string& error() const { return error_; }
+
+    SnapshotReader payload() const { return SnapshotReader(payload_, payloadSize_); }
+    size_t fileSize() const { return mappedSize_; }
+
+   private:
+    void close();
+
+    void* mapping_ = nullptr;
+    size_t mappedSize_ = 0;
+    std::vector<char> fallback_;  // used where mmap is unavailable
+    const char* payload_ = nullptr;
+    size_t payloadSize_ = 0;
+    std::string error_;
+};
+
+uint64_t snapshotChecksum(const char* data, size_t size);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * Where the time to the first prompt goes
+ *
+ * The clock starts when the report is made (first thing in main()). Each
+ * mark() ends a phase: it is charged the time since the previous mark. The
+ * engine marks its own steps when given a report, so construction and
+ * initialize() show up broken down rather than as one figure.
+ *
+ * Subsystems a game may never use (the random device, Session 2's inventory,
+ * the quest log) are set up on first use, so they don't appear here at all.
+ */
+class StartupReport {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    StartupReport() : start_(Clock::now()), last_(start_) {}
+
+    // Ends the current phase; phase names are string literals
+    void mark(std::string_view phase) {
+        Clock::time_point now = Clock::now();
+        phases_.push_back({phase, now - last_});
+        last_ = now;
+    }
+
+    Clock::duration total() const { return last_ - start_; }
+
+    void print(std::ostream& out) const {
+        double total = microseconds(this->total());
+        out << "Startup to first prompt\n";
+        for (const Phase& phase : phases_) {
+            double us = microseconds(phase.elapsed);
+            label(out, phase.name);
+            out << us << " us (" << (total > 0.0 ? us * 100.0 / total : 0.0) << "%)\n";
+        }
+        label(out, "Total");
+        out << total << " us\n";
+    }
+
+   private:
+    struct Phase {
+        std::string_view name;
+        Clock::duration elapsed;
+    };
+
+    static void label(std::ostream& out, std::string_view name) {
+        out << "  " << name << ":";
+        for (size_t column = name.size(); column < 26; ++column) {
+            out << ' ';
+        }
+    }
+
+    static double microseconds(Clock::duration elapsed) {
+        return std::chrono::duration<double, std::micro>(elapsed).count();
+    }
+
+    Clock::time_point start_;
+    Clock::time_point last_;
+    std::vector<Phase> phases_;
+};
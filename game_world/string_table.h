@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "snapshot.h"
+
+/**
+ * Interned strings
+ *
+ * Each distinct string is stored once and referred to by a dense 32-bit id.
+ * The index is an open-addressing table of ids hashed by content, so looking
+ * a string up neither allocates nor keeps a second copy of it as a key.
+ */
+class StringTable {
+   public:
+    static constexpr uint32_t NONE = ~uint32_t{0};
+
+    uint32_t intern(std::string_view text) {
+        if ((strings_.size() + 1) * 4 > slots_.size() * 3) {
+            rehash(slots_.empty() ? 16 : slots_.size() * 2);
+        }
+        size_t slot = slotOf(text);
+        if (slots_[slot] == NONE) {
+            slots_[slot] = static_cast<uint32_t>(strings_.size());
+            strings_.emplace_back(text);
+        }
+        return slots_[slot];
+    }
+
+    // Id of an interned string, or NONE
+    uint32_t find(std::string_view text) const {
+        return slots_.empty() ? NONE : slots_[slotOf(text)];
+    }
+
+    const std::string& text(uint32_t id) const { return strings_[id]; }
+    size_t size() const { return strings_.size(); }
+
+    size_t memoryBytes() const {
+        // Strings short enough for the small-string buffer have no heap block
+        const size_t inlineCapacity = std::string().capacity();
+        size_t bytes = strings_.capacity() * sizeof(std::string) + slots_.capacity() * 4;
+        for (const auto& s : strings_) {
+            bytes += s.capacity() > inlineCapacity ? s.capacity() : 0;
+        }
+        return bytes;
+    }
+
+    void writeSnapshot(SnapshotWriter& out) const {
+        out.put<uint64_t>(strings_.size());
+        for (const auto& s : strings_) {
+            out.putString(s);
+        }
+    }
+
+    bool readSnapshot(SnapshotReader& in) {
+        uint64_t count = 0;
+        if (!in.get(count)) {
+            return false;
+        }
+        *this = StringTable();
+        std::string text;
+        for (uint64_t i = 0; i < count; ++i) {
+            if (!in.getString(text)) {
+                return false;
+            }
+            intern(text);
+        }
+        // A duplicate would have been merged, shifting every later id
+        return strings_.size() == count;
+    }
+
+   private:
+    static uint64_t hash(std::string_view text) {
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (char c : text) {
+            h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+        }
+        return h ^ (h >> 32);
+    }
+
+    // The slot holding text, or the empty slot where it would go (linear probing)
+    size_t slotOf(std::string_view text) const {
+        size_t mask = slots_.size() - 1;
+        size_t slot = static_cast<size_t>(hash(text)) & mask;
+        while (slots_[slot] != NONE && strings_[slots_[slot]] != text) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void rehash(size_t capacity) {
+        slots_.assign(capacity, NONE);
+        for (uint32_t id = 0; id < strings_.size(); ++id) {
+            slots_[slotOf(strings_[id])] = id;
+        }
+    }
+
+    std::vector<std::string> strings_;
+    std::vector<uint32_t> slots_;  // power-of-two size, at most 3/4 full
+};
@@ -0,0 +1,56 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command_table.h"
+#include "test_game.h"
+#include "test_harness.h"
+
+/*
+ * Command lines: each command takes only an argument of the kind it expects,
+ * and a word that isn't one is the next command.
+ */
+
+namespace {
+
+// The line's commands, with their arguments, as "verb:argument" (or just "verb")
+std::vector<std::string> parse(std::string_view line) {
+    CommandParser parser;
+    parser.reset(line);
+    std::vector<std::string> commands;
+    ParsedCommand command;
+    while (parser.next(command)) {
+        std::string parsed(command.verb);
+        if (!command.argument.empty()) {
+            parsed += ":" + std::string(command.argument);
+        }
+        commands.push_back(parsed);
+    }
+    return commands;
+}
+
+using Commands = std::vector<std::string>;
+
+}  // namespace
+
+TEST_CASE(commands_take_only_their_arguments) {
+    CHECK(parse("go north fight") == (Commands{"go:north", "fight"}));
+    CHECK(parse("go fight") == (Commands{"go", "fight"}));
+    CHECK(parse("go") == (Commands{"go"}));
+    CHECK(parse("loot 2 n") == (Commands{"loot:2", "n"}));
+    CHECK(parse("loot n") == (Commands{"loot", "n"}));
+    CHECK(parse("loot -1 look") == (Commands{"loot:-1", "look"}));
+    CHECK(parse("loot - look") == (Commands{"loot", "-", "look"}));
+    CHECK(parse("goto Old Library") == (Commands{"goto:Old Library"}));
+
+    // "go fight" asks where to go and still fights; "loot -1" refuses the item
+    TestGame game;
+    std::string output = game.play("n go fight");
+    CHECK(output.find("Go where?") != std::string::npos);
+    CHECK(output.find("Unknown command") == std::string::npos);
+    CHECK(game.play("fight").find("nothing to fight") != std::string::npos);
+    output = game.play("loot -1");
+    CHECK(output.find("There is no item -1 here") != std::string::npos);
+    CHECK(output.find("You collect") == std::string::npos);
+    CHECK(output.find("Unknown command") == std::string::npos);
+}
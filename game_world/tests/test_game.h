@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "game_engine.h"
+
+/**
+ * A seeded game for tests, playing command lines and capturing what they print
+ */
+class TestGame {
+   public:
+    explicit TestGame(uint64_t seed = 7) : game(in, sink) {
+        game.seedRandom(seed);
+        game.initialize();
+        sink.take();
+    }
+
+    // Starts or recovers a journal, discarding the recovery message
+    bool openJournal(const std::string& path) {
+        std::string error;
+        bool opened = game.openJournal(path, error);
+        game.prompt();
+        sink.take();
+        return opened;
+    }
+
+    // Output of one line of commands
+    std::string play(std::string_view line) {
+        game.handleLine(line);
+        return sink.take();
+    }
+
+    // Everything a player can see of the game, and its save file: equal for equal games
+    std::string state(const std::filesystem::path& savePath) {
+        std::string shown = play("stats inv look");
+        game.setSavePath(savePath.string());
+        play("save");
+        std::ifstream file(savePath.string() + ".bin", std::ios::binary);
+        return shown + std::string(std::istreambuf_iterator<char>(file),
+                                   std::istreambuf_iterator<char>());
+    }
+
+    std::istringstream in;
+    MemorySink sink;
+    GameEngine game;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+/**
+ * Minimal self-contained test harness for game_tests
+ *
+ * A test case is a function registered with TEST_CASE; CHECK() reports each
+ * failed condition and marks the case failed without stopping it. ctest runs
+ * each case on its own (game_tests <case>).
+ */
+
+namespace test {
+
+using CaseFn = void (*)();
+
+struct Case {
+    const char* name;
+    CaseFn fn;
+};
+
+inline std::vector<Case>& registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+// Checks failed by the case now running
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* condition) {
+    std::printf("%s:%d: CHECK(%s) failed\n", file, line, condition);
+    ++failures();
+}
+
+struct Register {
+    Register(const char* name, CaseFn fn) { registry().push_back({name, fn}); }
+};
+
+}  // namespace test
+
+#define TEST_CASE(name)                                        \
+    static void name();                                        \
+    static const test::Register name##_registration(#name, name); \
+    static void name()
+
+#define CHECK(condition)                                   \
+    do {                                                   \
+        if (!(condition)) {                                \
+            test::fail(__FILE__, __LINE__, #condition);    \
+        }                                                  \
+    } while (false)
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+#include "private_dir.h"
+#include "test_game.h"
+#include "test_harness.h"
+
+/*
+ * Crash recovery: a journal cut off mid-record, or compacted around a new
+ * base, replays to the same game as one that was never interrupted.
+ */
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Fights, loots and walks around the built-in dungeon
+constexpr const char* OPENING = "look n fight loot e loot w w loot e n fight loot";
+
+}  // namespace
+
+TEST_CASE(journal_torn_tail) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+    std::string path = (dir.path() / "game.journal").string();
+
+    size_t played = 0;
+    {
+        TestGame crashed;
+        CHECK(crashed.openJournal(path));
+        crashed.play(OPENING);
+        played = fs::file_size(path);
+        crashed.play("s");
+    }
+    // The last record loses its final byte, as if the process died mid-write
+    CHECK(fs::file_size(path) > played);
+    fs::resize_file(path, fs::file_size(path) - 1);
+
+    TestGame uninterrupted;
+    uninterrupted.play(OPENING);
+
+    TestGame recovered(99);  // the seed comes from the journal
+    CHECK(recovered.openJournal(path));
+    CHECK(fs::file_size(path) == played);
+    CHECK(recovered.state(dir.path() / "recovered") ==
+          uninterrupted.state(dir.path() / "uninterrupted"));
+
+    // Play goes on in the same journal, from where the valid part ended
+    recovered.play("s fight");
+    uninterrupted.play("s fight");
+    TestGame reopened(99);
+    CHECK(reopened.openJournal(path));
+    CHECK(reopened.state(dir.path() / "reopened") ==
+          uninterrupted.state(dir.path() / "uninterrupted"));
+}
+
+TEST_CASE(journal_compaction) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+    std::string path = (dir.path() / "game.journal").string();
+
+    TestGame journaled;
+    TestGame plain;
+    CHECK(journaled.openJournal(path));
+    journaled.play(OPENING);
+    plain.play(OPENING);
+
+    // Enough commands to pass the compaction threshold; the journal shrinks back to a base
+    size_t longest = 0;
+    for (int i = 0; i < 5000; ++i) {
+        journaled.play("look");
+        plain.play("look");
+        longest = std::max<size_t>(longest, fs::file_size(path));
+    }
+    CHECK(fs::file_size(path) < longest);
+
+    journaled.play("s fight");
+    plain.play("s fight");
+    std::string expected = plain.state(dir.path() / "plain");
+    CHECK(journaled.state(dir.path() / "journaled") == expected);
+
+    TestGame recovered(99);
+    CHECK(recovered.openJournal(path));
+    CHECK(recovered.state(dir.path() / "recovered") == expected);
+}
+
+TEST_CASE(journal_unreadable_kept) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+    fs::path path = dir.path() / "game.journal";
+
+    // Something that can't be read where the journal should be is an error, not a new journal
+    fs::create_directory(path);
+    TestGame game;
+    CHECK(!game.game.openJournal(path.string(), error));
+    CHECK(error.find("Could not read journal") != std::string::npos);
+    CHECK(error.find(path.string()) != std::string::npos);
+    CHECK(fs::is_directory(path));
+}
@@ -0,0 +1,42 @@
+#include <cstdio>
+#include <string>
+
+#include "test_harness.h"
+
+/*
+ * game_tests [case...]
+ *
+ * Runs the named cases, or every registered case, and exits with 1 if any
+ * check failed. --list prints the case names.
+ */
+
+int main(int argc, char* argv[]) {
+    if (argc == 2 && std::string(argv[1]) == "--list") {
+        for (const auto& c : test::registry()) {
+            std::printf("%s\n", c.name);
+        }
+        return 0;
+    }
+
+    int failed = 0;
+    int ran = 0;
+    for (const auto& c : test::registry()) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || std::string(argv[i]) == c.name;
+        }
+        if (!selected) {
+            continue;
+        }
+        test::failures() = 0;
+        c.fn();
+        ++ran;
+        std::printf("%-32s %s\n", c.name, test::failures() == 0 ? "ok" : "FAILED");
+        failed += test::failures() != 0;
+    }
+    if (ran == 0) {
+        std::printf("No test case matched\n");
+        return 1;
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+#include <atomic>
+#include <vector>
+
+#include "test_harness.h"
+#include "work_stealing_pool.h"
+
+/*
+ * The host's worker pool: every task runs exactly once, including tasks that
+ * workers submit themselves and tasks still queued when the pool is destroyed.
+ */
+
+namespace {
+
+struct Job {
+    unsigned id = 0;
+    unsigned resubmits = 0;  // how many more times the job queues a follow-up of itself
+};
+
+}  // namespace
+
+TEST_CASE(pool_runs_every_task) {
+    const unsigned jobs = 2000;
+    const unsigned resubmits = 3;
+    std::vector<std::atomic<unsigned>> runs(jobs);
+    std::atomic<unsigned> sameWorker{0};
+    std::atomic<unsigned> followUps{0};
+    {
+        WorkStealingPool<Job>* self = nullptr;
+        std::vector<std::atomic<int>> lastWorker(jobs);
+        WorkStealingPool<Job> pool(4, [&](Job& job, unsigned worker) {
+            runs[job.id].fetch_add(1);
+            if (job.resubmits < resubmits && lastWorker[job.id].load() >= 0) {
+                followUps.fetch_add(1);
+                sameWorker += lastWorker[job.id].load() == static_cast<int>(worker);
+            }
+            lastWorker[job.id].store(static_cast<int>(worker));
+            if (job.resubmits > 0) {
+                self->submit({job.id, job.resubmits - 1});
+            }
+        });
+        self = &pool;
+        for (unsigned id = 0; id < jobs; ++id) {
+            lastWorker[id].store(-1);
+            pool.submit({id, resubmits});
+        }
+    }  // the destructor runs whatever is still queued
+
+    unsigned wrong = 0;
+    for (const auto& count : runs) {
+        wrong += count.load() != resubmits + 1;
+    }
+    CHECK(wrong == 0);
+    CHECK(followUps.load() == jobs * resubmits);
+    // Follow-ups go on the submitting worker's own queue; only a steal moves one elsewhere
+    CHECK(sameWorker.load() > 0);
+}
+
+TEST_CASE(pool_idle_and_busy) {
+    // Submits arriving one at a time (workers asleep between them) and in bursts
+    std::atomic<unsigned> ran{0};
+    WorkStealingPool<unsigned> pool(3, [&](unsigned&, unsigned) { ran.fetch_add(1); });
+    for (unsigned round = 0; round < 200; ++round) {
+        unsigned target = ran.load() + 1;
+        pool.submit(round);
+        while (ran.load() < target) {
+            std::this_thread::yield();
+        }
+    }
+    for (unsigned i = 0; i < 5000; ++i) {
+        pool.submit(i);
+    }
+    while (ran.load() < 5200) {
+        std::this_thread::yield();
+    }
+    CHECK(ran.load() == 5200);
+}
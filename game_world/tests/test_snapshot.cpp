@@ -0,0 +1,125 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "private_dir.h"
+#include "test_game.h"
+#include "test_harness.h"
+
+/*
+ * Binary saves: a loaded game is the game that was saved, and a damaged save
+ * is refused without touching the game in progress.
+ */
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Visits rooms, kills enemies and loots rooms into the bag
+constexpr const char* OPENING = "look n fight loot e loot w w loot e n";
+
+// Offset of the header's version field (after the 4-byte magic)
+constexpr size_t VERSION_OFFSET = 4;
+
+std::string readFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const fs::path& path, const std::string& bytes) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+}
+
+// Loads a save damaged by damage(saved bytes) into a game in progress; true if the game
+// refused it and carried on unchanged
+template <typename Damage>
+bool refusesDamagedSave(const PrivateDir& dir, Damage damage) {
+    TestGame saver;
+    saver.play(OPENING);
+    saver.state(dir.path() / "saved");
+    std::string bytes = readFile(dir.path() / "saved.bin");
+    damage(bytes);
+    writeFile(dir.path() / "damaged.bin", bytes);
+
+    TestGame loader;
+    loader.play("n");
+    std::string before = loader.state(dir.path() / "before");
+    loader.game.setSavePath((dir.path() / "damaged").string());
+    std::string output = loader.play("load");
+    return output.find("damaged or from another version") != std::string::npos &&
+           loader.state(dir.path() / "after") == before;
+}
+
+}  // namespace
+
+TEST_CASE(snapshot_round_trip) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+
+    TestGame saver;
+    saver.play(OPENING);
+    std::string saved = saver.state(dir.path() / "game");
+
+    // Loaded into a game elsewhere in the dungeon, with its own visits and enemies
+    TestGame loader;
+    std::string fresh = loader.state(dir.path() / "fresh");
+    loader.play("n fight");
+    loader.game.setSavePath((dir.path() / "game").string());
+    CHECK(loader.play("load").find("Game loaded successfully") != std::string::npos);
+    CHECK(loader.state(dir.path() / "loaded") == saved);
+    CHECK(saved != fresh);
+
+    // The loaded game plays on as the saved one does
+    saver.play("s fight loot");
+    loader.play("s fight loot");
+    CHECK(loader.state(dir.path() / "loaded") == saver.state(dir.path() / "saver"));
+}
+
+TEST_CASE(snapshot_rejects_flipped_byte) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+    CHECK(refusesDamagedSave(dir, [](std::string& bytes) { bytes[bytes.size() / 2] ^= 0x10; }));
+    CHECK(refusesDamagedSave(dir, [](std::string& bytes) { bytes.back() ^= 0x01; }));
+}
+
+TEST_CASE(snapshot_rejects_wrong_version) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+    CHECK(refusesDamagedSave(dir, [](std::string& bytes) {
+        uint32_t version;
+        std::memcpy(&version, bytes.data() + VERSION_OFFSET, sizeof(version));
+        ++version;
+        std::memcpy(bytes.data() + VERSION_OFFSET, &version, sizeof(version));
+    }));
+}
+
+TEST_CASE(snapshot_rejects_short_file) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+    CHECK(refusesDamagedSave(dir, [](std::string& bytes) { bytes.pop_back(); }));
+    CHECK(refusesDamagedSave(dir, [](std::string& bytes) { bytes.resize(10); }));
+    CHECK(refusesDamagedSave(dir, [](std::string& bytes) { bytes.clear(); }));
+}
+
+TEST_CASE(snapshot_reports_unreadable_save) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+
+    // No file is no save; a directory where the save should be is an error naming it
+    TestGame game;
+    game.game.setSavePath((dir.path() / "none").string());
+    CHECK(game.play("load").find("No save file found") != std::string::npos);
+    fs::create_directory(dir.path() / "blocked.bin");
+    game.game.setSavePath((dir.path() / "blocked").string());
+    std::string output = game.play("load");
+    CHECK(output.find("Could not read save file") != std::string::npos);
+    CHECK(output.find((dir.path() / "blocked.bin").string()) != std::string::npos);
+}
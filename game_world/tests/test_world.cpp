@@ -0,0 +1,138 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dungeon_generator.h"
+#include "private_dir.h"
+#include "route_index.h"
+#include "test_harness.h"
+#include "world_store.h"
+
+/*
+ * Worlds are copied only through cloneInMemory(), which gives an in-memory
+ * world with the same rooms whether the original is in memory or streamed.
+ * Copies share one routing graph until one of them changes its exits.
+ */
+
+namespace {
+
+std::string snapshotOf(const WorldStore& world) {
+    SnapshotWriter out;
+    world.writeSnapshot(out);
+    return std::string(out.data(), out.size());
+}
+
+// Some rooms visited and looted, so the clone has state of its own to carry over
+void play(WorldStore& world) {
+    for (WorldStore::RoomId room = 0; room < static_cast<WorldStore::RoomId>(world.roomCount());
+         room += 7) {
+        world.markVisited(room);
+        world.clearTreasure(room);
+    }
+}
+
+// Same rooms as the player sees them (a streamed world's snapshot packs treasure differently)
+bool sameRooms(const WorldStore& a, const WorldStore& b) {
+    if (a.roomCount() != b.roomCount()) {
+        return false;
+    }
+    for (WorldStore::RoomId room = 0; room < static_cast<WorldStore::RoomId>(a.roomCount());
+         ++room) {
+        if (a.name(room) != b.name(room) || a.exits(room) != b.exits(room) ||
+            a.visited(room) != b.visited(room) || a.treasureCount(room) != b.treasureCount(room)) {
+            return false;
+        }
+        for (size_t i = 0; i < a.treasureCount(room); ++i) {
+            if (a.treasureItem(room, i) != b.treasureItem(room, i)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE(world_clone_in_memory) {
+    GeneratorOptions options;
+    options.rooms = 5000;
+    GeneratedDungeon dungeon = generateDungeon(options);
+    play(dungeon.world);
+
+    WorldStore clone = dungeon.world.cloneInMemory();
+    CHECK(clone.sharesLayoutWith(dungeon.world));
+    CHECK(snapshotOf(clone) == snapshotOf(dungeon.world));
+
+    // The clone's state is its own
+    clone.markVisited(1);
+    clone.clearTreasure(1);
+    CHECK(snapshotOf(clone) != snapshotOf(dungeon.world));
+}
+
+TEST_CASE(world_clone_streamed) {
+    PrivateDir dir;
+    std::string error;
+    CHECK(dir.create("cpp_quest_test_", error));
+
+    GeneratorOptions options;
+    options.rooms = 5000;
+    GeneratedDungeon dungeon = generateDungeon(options);
+
+    WorldStore streamed = dungeon.world.cloneInMemory();
+    CHECK(streamed.streamTo((dir.path() / "world.chunks").string(), 4));
+    play(streamed);
+    play(dungeon.world);
+
+    WorldStore clone = streamed.cloneInMemory();
+    CHECK(!clone.streamed());
+    CHECK(streamed.streamed());
+    CHECK(sameRooms(clone, dungeon.world));
+    CHECK(sameRooms(streamed, dungeon.world));
+    CHECK(snapshotOf(clone) == snapshotOf(streamed));
+}
+
+TEST_CASE(world_routes_shared) {
+    GeneratorOptions options;
+    options.rooms = 5000;
+    GeneratedDungeon dungeon = generateDungeon(options);
+    const WorldStore::RoomId far = 4999;
+
+    // The first query builds the graph; every other copy's index takes it from the layout
+    WorldStore first = dungeon.world.cloneInMemory();
+    RouteIndex firstIndex;
+    std::vector<WorldStore::RoomId> expected;
+    CHECK(firstIndex.route(first, 0, far, expected));
+    CHECK(dungeon.world.cachedRoutes() != nullptr);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<WorldStore::RoomId>> paths(4);
+    std::vector<char> shared(paths.size(), 0);
+    for (size_t t = 0; t < paths.size(); ++t) {
+        threads.emplace_back([&, t] {
+            WorldStore copy = dungeon.world.cloneInMemory();
+            RouteIndex index;
+            index.route(copy, 0, far, paths[t]);
+            shared[t] = index.shared();
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (size_t t = 0; t < paths.size(); ++t) {
+        CHECK(shared[t]);
+        CHECK(paths[t] == expected);
+    }
+
+    // A copy that adds an exit patches a graph of its own; the others keep the shared one
+    WorldStore carved = dungeon.world.cloneInMemory();
+    RouteIndex carvedIndex;
+    std::vector<WorldStore::RoomId> path;
+    carvedIndex.route(carved, 0, far, path);
+    carved.setExit(0, 'w', far);
+    carvedIndex.exitAdded(carved, 0, far);
+    CHECK(!carvedIndex.shared());
+    CHECK(carvedIndex.route(carved, 0, far, path) && path.size() == 1);
+    CHECK(dungeon.world.cachedRoutes() != nullptr);
+    CHECK(carved.cachedRoutes() == nullptr);
+    CHECK(firstIndex.route(first, 0, far, path) && path == expected);
+}
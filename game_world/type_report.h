@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Type reports built at compile time
+ *
+ * A report is a type with a static write(out) that describes some types:
+ * limits() for arithmetic types (size, alignment, min, max) and layout() for
+ * structs (size, alignment, each field's offset and size, and the padding
+ * between and after them). prebuilt<Report>() runs write() twice in a
+ * constant expression, once to count and once to fill, so the program holds
+ * the finished text and printing it is one write.
+ *
+ * A struct's fields are listed by specializing Layout<T> (see
+ * TYPE_REPORT_FIELD); there is no reflection to find them. Numbers are
+ * formatted as std::ostream formats them by default (six significant digits
+ * for floating point), so limitsBlock<T>() reads exactly like Session 1's
+ * displayTypeInfo() always has.
+ *
+ * Also builds with the sessions' C++17.
+ */
+namespace typereport {
+
+// Counts what a report writes
+struct Counter {
+    size_t size = 0;
+
+    constexpr void put(char) { ++size; }
+    constexpr void put(std::string_view text) { size += text.size(); }
+};
+
+// Holds a finished report
+template <size_t N>
+struct Text {
+    char data[N + 1] = {};
+    size_t size = 0;
+
+    constexpr void put(char c) { data[size++] = c; }
+    constexpr void put(std::string_view text) {
+        for (char c : text) {
+            put(c);
+        }
+    }
+
+    constexpr std::string_view view() const { return {data, size}; }
+};
+
+template <typename Report>
+constexpr size_t reportSize() {
+    Counter counter;
+    Report::write(counter);
+    return counter.size;
+}
+
+template <typename Report>
+constexpr Text<reportSize<Report>()> build() {
+    Text<reportSize<Report>()> text;
+    Report::write(text);
+    return text;
+}
+
+template <typename Report>
+inline constexpr auto PREBUILT = build<Report>();
+
+// The report's text, finished at compile time
+template <typename Report>
+constexpr std::string_view prebuilt() {
+    return PREBUILT<Report>.view();
+}
+
+// --- Numbers -----------------------------------------------------------------------------
+
+template <typename Out>
+constexpr void putUnsigned(Out& out, unsigned long long value) {
+    char digits[20] = {};
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) {
+        out.put(digits[--count]);
+    }
+}
+
+template <typename Out, typename Int>
+constexpr void putInteger(Out& out, Int value) {
+    if constexpr (std::is_signed_v<Int>) {
+        if (value < 0) {
+            out.put('-');
+            putUnsigned(out, 0ull - static_cast<unsigned long long>(value));
+            return;
+        }
+    }
+    putUnsigned(out, static_cast<unsigned long long>(value));
+}
+
+// As std::ostream's default (%g with six significant digits). Scaling by ten one step at a
+// time loses far less than the sixth digit, even across long double's range.
+template <typename Out>
+constexpr void putFloat(Out& out, long double value) {
+    constexpr int PRECISION = 6;
+    if (value == 0) {
+        out.put('0');
+        return;
+    }
+    if (value < 0) {
+        out.put('-');
+        value = -value;
+    }
+    int exponent = 0;
+    for (; value >= 10; ++exponent) {
+        value /= 10;
+    }
+    for (; value < 1; --exponent) {
+        value *= 10;
+    }
+    auto significand = static_cast<unsigned long long>(value * 100000 + 0.5L);
+    if (significand >= 1000000) {  // rounded up to the next power of ten
+        significand /= 10;
+        ++exponent;
+    }
+    char digits[PRECISION] = {};
+    for (int i = PRECISION - 1; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + significand % 10);
+        significand /= 10;
+    }
+    int kept = PRECISION;  // trailing zeros are dropped
+    while (kept > 1 && digits[kept - 1] == '0') {
+        --kept;
+    }
+
+    if (exponent < -4 || exponent >= PRECISION) {
+        out.put(digits[0]);
+        if (kept > 1) {
+            out.put('.');
+            for (int i = 1; i < kept; ++i) {
+                out.put(digits[i]);
+            }
+        }
+        out.put('e');
+        out.put(exponent < 0 ? '-' : '+');
+        int magnitude = exponent < 0 ? -exponent : exponent;
+        if (magnitude < 10) {
+            out.put('0');
+        }
+        putUnsigned(out, static_cast<unsigned long long>(magnitude));
+    } else if (exponent >= 0) {
+        for (int i = 0; i <= exponent; ++i) {
+            out.put(i < kept ? digits[i] : '0');
+        }
+        if (kept > exponent + 1) {
+            out.put('.');
+            for (int i = exponent + 1; i < kept; ++i) {
+                out.put(digits[i]);
+            }
+        }
+    } else {
+        out.put("0.");
+        for (int i = -1; i > exponent; --i) {
+            out.put('0');
+        }
+        for (int i = 0; i < kept; ++i) {
+            out.put(digits[i]);
+        }
+    }
+}
+
+// A value as `std::cout << value` prints it: character types as the character itself
+template <typename Out, typename T>
+constexpr void putStreamed(Out& out, T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        putFloat(out, value);
+    } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+                         std::is_same_v<T, unsigned char>) {
+        out.put(static_cast<char>(value));
+    } else {
+        putInteger(out, value);
+    }
+}
+
+// A value as a number, character types included
+template <typename Out, typename T>
+constexpr void putNumber(Out& out, T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        putFloat(out, value);
+    } else {
+        putInteger(out, value);
+    }
+}
+
+template <typename Out>
+constexpr void putBytes(Out& out, size_t bytes) {
+    putUnsigned(out, bytes);
+    out.put(bytes == 1 ? " byte" : " bytes");
+}
+
+// --- Arithmetic types --------------------------------------------------------------------
+
+// displayTypeInfo()'s lines after the name
+template <typename T>
+struct LimitsBlock {
+    template <typename Out>
+    static constexpr void write(Out& out) {
+        out.put("  Size: ");
+        putUnsigned(out, sizeof(T));
+        out.put(" bytes\n  Min:  ");
+        putStreamed(out, std::numeric_limits<T>::min());
+        out.put("\n  Max:  ");
+        putStreamed(out, std::numeric_limits<T>::max());
+        out.put('\n');
+    }
+};
+
+template <typename T>
+constexpr std::string_view limitsBlock() {
+    return prebuilt<LimitsBlock<T>>();
+}
+
+// One line: name, size, alignment, lowest and highest value
+template <typename T, typename Out>
+constexpr void limits(Out& out, std::string_view name) {
+    static_assert(std::is_arithmetic_v<T>);
+    out.put("  ");
+    out.put(name);
+    for (size_t column = name.size(); column < 20; ++column) {
+        out.put(' ');
+    }
+    putBytes(out, sizeof(T));
+    out.put(", align ");
+    putUnsigned(out, alignof(T));
+    out.put(", ");
+    putNumber(out, std::numeric_limits<T>::lowest());
+    out.put(" to ");
+    putNumber(out, std::numeric_limits<T>::max());
+    out.put('\n');
+}
+
+// --- Structs -----------------------------------------------------------------------------
+
+struct Field {
+    std::string_view name;
+    size_t offset;
+    size_t size;
+};
+
+// Specialize with `static constexpr std::string_view name` and `static constexpr Field
+// fields[]` (in declaration order) for each struct a report lays out
+template <typename T>
+struct Layout;
+
+#define TYPE_REPORT_FIELD(Struct, member) \
+    ::typereport::Field { #member, offsetof(Struct, member), sizeof(Struct::member) }
+
+template <typename T>
+constexpr size_t paddingBytes() {
+    size_t used = 0;
+    for (const Field& field : Layout<T>::fields) {
+        used += field.size;
+    }
+    return sizeof(T) - used;
+}
+
+// The struct's size, alignment and padding, then a line per field with any padding after it
+template <typename T, typename Out>
+constexpr void layout(Out& out) {
+    out.put(Layout<T>::name);
+    out.put(": ");
+    putBytes(out, sizeof(T));
+    out.put(", align ");
+    putUnsigned(out, alignof(T));
+    out.put(", ");
+    putBytes(out, paddingBytes<T>());
+    out.put(" of padding\n");
+
+    const auto& fields = Layout<T>::fields;
+    size_t count = sizeof(fields) / sizeof(fields[0]);
+    for (size_t i = 0; i < count; ++i) {
+        const Field& field = fields[i];
+        size_t next = i + 1 < count ? fields[i + 1].offset : sizeof(T);
+        out.put("  ");
+        out.put(field.name);
+        for (size_t column = field.name.size(); column < 18; ++column) {
+            out.put(' ');
+        }
+        out.put("offset ");
+        if (field.offset < 10) {
+            out.put(' ');
+        }
+        putUnsigned(out, field.offset);
+        out.put(", ");
+        putBytes(out, field.size);
+        if (next > field.offset + field.size) {
+            out.put(" + ");
+            putBytes(out, next - field.offset - field.size);
+            out.put(" padding");
+        }
+        out.put('\n');
+    }
+}
+
+}  // namespace typereport
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed pool of worker threads with one task queue each
+ *
+ * submit() spreads tasks round-robin over the queues; a task submitted from
+ * one of the pool's own workers goes on that worker's queue instead. A worker
+ * takes from the front of its own queue and, when that is empty, steals from
+ * the back of the others, so a worker stuck on a slow task doesn't hold up the
+ * rest of its queue. Queues are skipped without locking while they are empty.
+ *
+ * An idle worker sleeps on a signal of its own. submit() wakes one only when
+ * some worker has gone to sleep, so a busy pool never takes a shared lock or
+ * makes a system call to queue a task.
+ */
+template <typename Task>
+class WorkStealingPool {
+   public:
+    using Handler = std::function<void(Task&, unsigned worker)>;
+
+    WorkStealingPool(unsigned workers, Handler handler) : handler_(std::move(handler)) {
+        workers = workers == 0 ? 1 : workers;
+        for (unsigned i = 0; i < workers; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned i = 0; i < workers; ++i) {
+            threads_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    // Finishes the queued tasks, then joins the workers
+    ~WorkStealingPool() {
+        stopping_.store(true);
+        for (auto& queue : queues_) {
+            signal(*queue);
+        }
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task) {
+        unsigned id = current_.pool == this
+                          ? current_.worker
+                          : next_.fetch_add(1, std::memory_order_relaxed) % size();
+        Queue& queue = *queues_[id];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+            queue.size.fetch_add(1);
+        }
+        // Pairs with the sleeper count a worker raises before its last look at the queues:
+        // either it sees the task, or this sees it asleep
+        if (sleepers_.load() > 0) {
+            wakeOne(id);
+        }
+    }
+
+    unsigned size() const { return static_cast<unsigned>(queues_.size()); }
+    size_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+   private:
+    // A worker's queue, and the signal it sleeps on
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<size_t> size{0};  // tasks.size(), readable without the lock
+
+        std::atomic<bool> sleeping{false};
+        std::atomic<uint32_t> signal{0};
+    };
+
+    // The pool and worker the calling thread belongs to, if any
+    struct Current {
+        const WorkStealingPool* pool = nullptr;
+        unsigned worker = 0;
+    };
+    static inline thread_local Current current_;
+
+    static bool popFront(Queue& queue, Task& out) {
+        if (queue.size.load() == 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        out = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queue.size.fetch_sub(1);
+        return true;
+    }
+
+    static bool popBack(Queue& queue, Task& out) {
+        if (queue.size.load() == 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        out = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        queue.size.fetch_sub(1);
+        return true;
+    }
+
+    bool tryPop(unsigned id, Task& out) {
+        if (popFront(*queues_[id], out)) {
+            return true;
+        }
+        for (size_t offset = 1; offset < queues_.size(); ++offset) {
+            if (popBack(*queues_[(id + offset) % queues_.size()], out)) {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void signal(Queue& queue) {
+        queue.signal.fetch_add(1);
+        queue.signal.notify_one();
+    }
+
+    // Wakes the worker of queue id if it sleeps, or else any sleeping worker. Clearing its
+    // flag claims a worker, so two submits never spend their wake-ups on the same one.
+    void wakeOne(unsigned id) {
+        for (size_t offset = 0; offset < queues_.size(); ++offset) {
+            Queue& queue = *queues_[(id + offset) % queues_.size()];
+            if (queue.sleeping.load() && queue.sleeping.exchange(false)) {
+                signal(queue);
+                return;
+            }
+        }
+    }
+
+    void workerLoop(unsigned id) {
+        current_ = {this, id};
+        Queue& own = *queues_[id];
+        Task task;
+        for (;;) {
+            if (tryPop(id, task)) {
+                handler_(task, id);
+                continue;
+            }
+
+            // Announce the sleep before looking once more, so a task submitted meanwhile is
+            // either found here or wakes us
+            uint32_t seen = own.signal.load();
+            own.sleeping.store(true);
+            sleepers_.fetch_add(1);
+            bool found = tryPop(id, task);
+            bool stop = !found && stopping_.load();
+            if (!found && !stop) {
+                own.signal.wait(seen);
+            }
+            own.sleeping.store(false);
+            sleepers_.fetch_sub(1);
+            if (found) {
+                handler_(task, id);
+            } else if (stop) {
+                return;  // stopping, and nothing left to run
+            }
+        }
+    }
+
+    Handler handler_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<unsigned> sleepers_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<unsigned> next_{0};
+    std::atomic<size_t> steals_{0};
+};
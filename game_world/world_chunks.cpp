@@ -0,0 +1,144 @@
+#include "world_chunks.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// The file is this run's own scratch space; losing a chunk would lose the world
+[[noreturn]] void failChunk(const char* what, uint32_t id, const std::string& path) {
+    std::fprintf(stderr, "Could not %s world chunk %u in %s\n", what, id, path.c_str());
+    std::abort();
+}
+
+bool seek(std::FILE* file, uint64_t offset) {
+    return std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0;
+}
+
+}  // namespace
+
+WorldChunks::~WorldChunks() { close(); }
+
+void WorldChunks::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+        std::remove(path_.c_str());
+    }
+}
+
+bool WorldChunks::create(const std::string& path, size_t capacity) {
+    close();
+    path_ = path;
+    file_ = std::fopen(path.c_str(), "w+b");
+    rooms_ = 0;
+    extents_.clear();
+    slotOf_.clear();
+    slots_.clear();
+    clock_ = 0;
+    stats_ = ChunkCacheStats();
+    stats_.capacity = std::max<size_t>(capacity, 1);
+    return file_ != nullptr;
+}
+
+bool WorldChunks::append(const std::vector<Room>& rooms, const std::vector<ItemId>& items) {
+    Extent extent{0, static_cast<uint32_t>(rooms.size()), static_cast<uint32_t>(items.size())};
+    if (!extents_.empty()) {
+        const Extent& last = extents_.back();
+        extent.offset = last.offset + last.rooms * sizeof(Room) + last.items * sizeof(ItemId);
+    }
+    if (!seek(file_, extent.offset) ||
+        std::fwrite(rooms.data(), sizeof(Room), rooms.size(), file_) != rooms.size() ||
+        std::fwrite(items.data(), sizeof(ItemId), items.size(), file_) != items.size()) {
+        return false;
+    }
+    extents_.push_back(extent);
+    slotOf_.push_back(NONE);
+    rooms_ += rooms.size();
+    return true;
+}
+
+void WorldChunks::removeItem(RoomId room, size_t i) {
+    Chunk& chunk = chunkOf(room);
+    chunk.dirty = true;
+    Room& record = chunk.rooms[room % ROOMS_PER_CHUNK];
+    auto span = chunk.items.begin() + record.treasureBegin;
+    std::rotate(span + static_cast<ptrdiff_t>(i), span + static_cast<ptrdiff_t>(i) + 1,
+                span + record.treasureCount);
+    --record.treasureCount;
+}
+
+void WorldChunks::prefetch(RoomId room) {
+    auto id = static_cast<uint32_t>(static_cast<size_t>(room) / ROOMS_PER_CHUNK);
+    if (slotOf_[id] == NONE) {
+        ++stats_.prefetches;
+        slots_[load(id)].lastUse = ++clock_;
+    }
+}
+
+bool WorldChunks::flush() {
+    bool ok = true;
+    for (Chunk& chunk : slots_) {
+        if (chunk.dirty) {
+            ok = writeBack(chunk) && ok;
+        }
+    }
+    return ok && std::fflush(file_) == 0;
+}
+
+ChunkCacheStats WorldChunks::stats() const {
+    ChunkCacheStats stats = stats_;
+    stats.chunks = extents_.size();
+    stats.resident = slots_.size();
+    stats.residentBytes = 0;
+    for (const Chunk& chunk : slots_) {
+        stats.residentBytes +=
+            chunk.rooms.capacity() * sizeof(Room) + chunk.items.capacity() * sizeof(ItemId);
+    }
+    return stats;
+}
+
+uint32_t WorldChunks::load(uint32_t id) {
+    uint32_t slot;
+    if (slots_.size() < stats_.capacity) {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    } else {
+        auto oldest = std::min_element(
+            slots_.begin(), slots_.end(),
+            [](const Chunk& a, const Chunk& b) { return a.lastUse < b.lastUse; });
+        slot = static_cast<uint32_t>(oldest - slots_.begin());
+        if (oldest->dirty && !writeBack(*oldest)) {
+            failChunk("write back", oldest->id, path_);
+        }
+        slotOf_[oldest->id] = NONE;
+        ++stats_.evictions;
+    }
+
+    // The evicted chunk's vectors are reused, so a full cache loads without allocating
+    Chunk& chunk = slots_[slot];
+    const Extent& extent = extents_[id];
+    chunk.id = id;
+    chunk.dirty = false;
+    chunk.rooms.resize(extent.rooms);
+    chunk.items.resize(extent.items);
+    if (!seek(file_, extent.offset) ||
+        std::fread(chunk.rooms.data(), sizeof(Room), extent.rooms, file_) != extent.rooms ||
+        std::fread(chunk.items.data(), sizeof(ItemId), extent.items, file_) != extent.items) {
+        failChunk("read", id, path_);
+    }
+    slotOf_[id] = slot;
+    return slot;
+}
+
+bool WorldChunks::writeBack(Chunk& chunk) {
+    const Extent& extent = extents_[chunk.id];
+    if (!seek(file_, extent.offset) ||
+        std::fwrite(chunk.rooms.data(), sizeof(Room), extent.rooms, file_) != extent.rooms ||
+        std::fwrite(chunk.items.data(), sizeof(ItemId), extent.items, file_) != extent.items) {
+        return false;
+    }
+    chunk.dirty = false;
+    ++stats_.writebacks;
+    return true;
+}
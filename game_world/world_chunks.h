@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "item_registry.h"
+
+/**
+ * Rooms kept on disk in chunks, with a bounded LRU cache of resident ones
+ *
+ * A chunk is ROOMS_PER_CHUNK consecutive rooms: their records (name and
+ * description ids, exits, enemy span, visited flag, treasure span) followed
+ * by the chunk's treasure items. Treasure only ever leaves a room, so a chunk
+ * never outgrows its place in the file and is written back where it was read.
+ *
+ * At most `capacity` chunks are in memory. Every room read makes its chunk
+ * the most recently used; loading another chunk when the cache is full evicts
+ * the least recently used one, writing it back first if any of its rooms
+ * changed. prefetch() loads a chunk before it is needed, e.g. the chunks
+ * behind a room's exits as the player enters it.
+ *
+ * The file is scratch space for one world: it is created from an in-memory
+ * WorldStore and removed when the world goes away. Saves still go through
+ * snapshots.
+ */
+
+struct ChunkCacheStats {
+    uint64_t hits = 0;        // room reads whose chunk was resident
+    uint64_t misses = 0;      // room reads that had to load their chunk
+    uint64_t prefetches = 0;  // chunks loaded ahead of a read
+    uint64_t evictions = 0;
+    uint64_t writebacks = 0;  // evicted or flushed chunks that had changed
+    size_t chunks = 0;        // in the file
+    size_t capacity = 0;      // most chunks in memory at once
+    size_t resident = 0;
+    size_t residentBytes = 0;
+
+    double hitRate() const {
+        uint64_t reads = hits + misses;
+        return reads ? static_cast<double>(hits) / static_cast<double>(reads) : 1.0;
+    }
+};
+
+class WorldChunks {
+   public:
+    using RoomId = int32_t;
+    static constexpr size_t ROOMS_PER_CHUNK = 1024;
+
+    // A room as stored in its chunk; its treasure is items[treasureBegin, + treasureCount)
+    struct Room {
+        uint32_t nameId;
+        uint32_t descriptionId;
+        std::array<RoomId, 4> exits;
+        uint32_t enemyBegin;
+        uint16_t enemyCount;
+        uint16_t treasureCount;
+        uint32_t treasureBegin;
+        uint8_t visited;
+    };
+
+    WorldChunks() = default;
+    ~WorldChunks();
+    WorldChunks(const WorldChunks&) = delete;
+    WorldChunks& operator=(const WorldChunks&) = delete;
+
+    // Starts an empty chunk file at path (replacing any file there) that keeps up to
+    // `capacity` chunks in memory
+    bool create(const std::string& path, size_t capacity);
+    // Writes the next chunk: ROOMS_PER_CHUNK rooms (fewer for the last one) and their items
+    bool append(const std::vector<Room>& rooms, const std::vector<ItemId>& items);
+
+    size_t roomCount() const { return rooms_; }
+
+    const Room& room(RoomId room) { return chunkOf(room).rooms[room % ROOMS_PER_CHUNK]; }
+    Room& roomForWrite(RoomId room) {
+        Chunk& chunk = chunkOf(room);
+        chunk.dirty = true;
+        return chunk.rooms[room % ROOMS_PER_CHUNK];
+    }
+    ItemId item(RoomId room, size_t i) {
+        Chunk& chunk = chunkOf(room);
+        return chunk.items[chunk.rooms[room % ROOMS_PER_CHUNK].treasureBegin + i];
+    }
+    // Takes item i out of the room's treasure, keeping the others in order
+    void removeItem(RoomId room, size_t i);
+
+    // Makes the chunk holding room resident without counting a read
+    void prefetch(RoomId room);
+
+    // Writes every changed resident chunk back; false on a write error
+    bool flush();
+
+    ChunkCacheStats stats() const;
+
+   private:
+    static constexpr uint32_t NONE = ~uint32_t{0};
+
+    struct Chunk {
+        uint32_t id = NONE;
+        bool dirty = false;
+        uint64_t lastUse = 0;
+        std::vector<Room> rooms;
+        std::vector<ItemId> items;
+    };
+
+    // Where a chunk lives in the file
+    struct Extent {
+        uint64_t offset;
+        uint32_t rooms;
+        uint32_t items;
+    };
+
+    Chunk& chunkOf(RoomId room) {
+        auto id = static_cast<uint32_t>(static_cast<size_t>(room) / ROOMS_PER_CHUNK);
+        uint32_t slot = slotOf_[id];
+        if (slot != NONE) {
+            ++stats_.hits;
+        } else {
+            ++stats_.misses;
+            slot = load(id);
+        }
+        Chunk& chunk = slots_[slot];
+        chunk.lastUse = ++clock_;
+        return chunk;
+    }
+
+    // Reads chunk id into a free or evicted slot and returns the slot
+    uint32_t load(uint32_t id);
+    bool writeBack(Chunk& chunk);
+    void close();
+
+    std::FILE* file_ = nullptr;
+    std::string path_;
+    size_t rooms_ = 0;
+    std::vector<Extent> extents_;  // by chunk id
+    std::vector<uint32_t> slotOf_;  // by chunk id: its slot, or NONE when on disk only
+    std::vector<Chunk> slots_;      // at most stats_.capacity
+    uint64_t clock_ = 0;
+    ChunkCacheStats stats_;
+};
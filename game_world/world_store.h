@@ -0,0 +1,529 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "item_registry.h"
+#include "snapshot.h"
+#include "string_table.h"
+#include "world_chunks.h"
+
+struct RouteGraph;
+
+/**
+ * Flat, data-oriented storage for the dungeon
+ *
+ * Every room is a row index into parallel arrays (struct-of-arrays), so the
+ * fields touched on every move (exits, enemies, visited, treasure range) sit
+ * in tight contiguous columns instead of behind per-room heap objects. Exits
+ * use a fixed 4-slot array and all treasure lives in one flat array of item
+ * ids (see item_registry.h), with each room owning a [begin, begin + count)
+ * span of it. Enemies work the same way, with the span indexing an
+ * EnemyStore. Names and descriptions are interned in a StringTable and
+ * referenced by id.
+ *
+ * The columns play never changes (names, descriptions, exits, enemy and
+ * treasure spans) and the strings form a Layout that copies of a world share;
+ * a copy owns only the visited flags and the treasure still lying around.
+ * Construction copies a shared layout before changing it.
+ *
+ * streamTo() moves the rooms out to a chunk file (see world_chunks.h) and
+ * keeps only a bounded cache of them in memory; the accessors then read
+ * through the cache. Strings stay in memory. Reading a snapshot brings the
+ * whole world back into memory.
+ *
+ * A world is copied only on purpose, with cloneInMemory(); the copy is always
+ * an in-memory world.
+ *
+ * The layout also caches the routing graph built from its exits (see
+ * route_index.h), so copies of a world build it once between them. Changing
+ * an exit or adding rooms drops it.
+ */
+class WorldStore {
+   public:
+    using RoomId = int32_t;
+
+    static constexpr RoomId NO_ROOM = -1;
+    static constexpr int EXIT_SLOTS = 4;
+
+    // Slots are kept in the order exits are listed to the player
+    static constexpr std::array<char, EXIT_SLOTS> SLOT_DIRECTIONS = {'e', 'n', 's', 'w'};
+
+    static int exitSlot(char direction) {
+        switch (direction) {
+            case 'e':
+                return 0;
+            case 'n':
+                return 1;
+            case 's':
+                return 2;
+            case 'w':
+                return 3;
+            default:
+                return -1;
+        }
+    }
+
+    WorldStore() = default;
+    WorldStore(WorldStore&&) = default;
+    WorldStore& operator=(WorldStore&&) = default;
+    WorldStore(const WorldStore&) = delete;
+    WorldStore& operator=(const WorldStore&) = delete;
+
+    // A copy held in memory. An in-memory world shares its layout with the copy, which owns
+    // only the visited flags and treasure; a streamed one is read back through its cache
+    // into a world of its own (the chunk file stays with this world).
+    WorldStore cloneInMemory() const {
+        WorldStore copy;
+        if (streamed()) {
+            SnapshotWriter out;
+            writeSnapshot(out);
+            SnapshotReader in(out.data(), out.size());
+            bool read = copy.readSnapshot(in);
+            assert(read && in.atEnd());
+            (void)read;
+            return copy;
+        }
+        copy.layout_ = layout_;
+        copy.visited_ = visited_;
+        copy.treasureCount_ = treasureCount_;
+        copy.treasureItem_ = treasureItem_;
+        return copy;
+    }
+
+    void reserve(size_t rooms, size_t treasures) {
+        Layout& layout = edit();
+        layout.nameId.reserve(rooms);
+        layout.descriptionId.reserve(rooms);
+        layout.exits.reserve(rooms);
+        layout.enemyBegin.reserve(rooms);
+        layout.enemyCount.reserve(rooms);
+        layout.treasureBegin.reserve(rooms);
+        visited_.reserve(rooms);
+        treasureCount_.reserve(rooms);
+        treasureItem_.reserve(treasures);
+    }
+
+    RoomId addRoom(std::string_view name, std::string_view description) {
+        Layout& layout = edit();
+        assert(layout.nameId.size() < static_cast<size_t>(std::numeric_limits<RoomId>::max()));
+        layout.nameId.push_back(layout.strings.intern(name));
+        layout.descriptionId.push_back(layout.strings.intern(description));
+        layout.exits.push_back({NO_ROOM, NO_ROOM, NO_ROOM, NO_ROOM});
+        layout.enemyBegin.push_back(
+            layout.enemyBegin.empty() ? 0 : layout.enemyBegin.back() + layout.enemyCount.back());
+        layout.enemyCount.push_back(0);
+        layout.treasureBegin.push_back(static_cast<uint32_t>(treasureItem_.size()));
+        visited_.push_back(0);
+        treasureCount_.push_back(0);
+        layout.routes.clear();
+        return static_cast<RoomId>(layout.nameId.size() - 1);
+    }
+
+    void setExit(RoomId room, char direction, RoomId target) {
+        int slot = exitSlot(direction);
+        assert(slot >= 0);
+        if (streamed()) {
+            chunks_.file->roomForWrite(room).exits[slot] = target;
+            layout_->routes.clear();
+            return;
+        }
+        edit().exits[room][slot] = target;
+        layout_->routes.clear();
+    }
+
+    // Enemy spans are contiguous too: ids must be handed out in room order, and only to
+    // the newest room
+    void addEnemy(RoomId room, uint32_t enemy) {
+        Layout& layout = edit();
+        assert(room == static_cast<RoomId>(roomCount() - 1));
+        assert(enemy == layout.enemyBegin[room] + layout.enemyCount[room]);
+        (void)enemy;
+        ++layout.enemyCount[room];
+    }
+
+    // Treasure spans are contiguous, so treasure can only go into the newest room
+    void addTreasure(RoomId room, ItemId item) {
+        assert(room == static_cast<RoomId>(roomCount() - 1));
+        treasureItem_.push_back(item);
+        ++treasureCount_[room];
+    }
+
+    // Bulk construction for generators. Rooms and treasure slots are sized up
+    // front and then filled in place; distinct rooms may be filled from
+    // different threads. Strings must be interned before filling starts.
+    void resizeRooms(size_t rooms) {
+        Layout& layout = edit();
+        layout.nameId.assign(rooms, 0);
+        layout.descriptionId.assign(rooms, 0);
+        layout.exits.assign(rooms, {NO_ROOM, NO_ROOM, NO_ROOM, NO_ROOM});
+        layout.enemyBegin.assign(rooms, 0);
+        layout.enemyCount.assign(rooms, 0);
+        layout.treasureBegin.assign(rooms, 0);
+        visited_.assign(rooms, 0);
+        treasureCount_.assign(rooms, 0);
+        layout.routes.clear();
+    }
+    void resizeTreasure(size_t slots) { treasureItem_.assign(slots, 0); }
+    uint32_t internString(std::string_view text) { return edit().strings.intern(text); }
+    void setRoomText(RoomId room, uint32_t nameId, uint32_t descriptionId) {
+        Layout& layout = edit();
+        layout.nameId[room] = nameId;
+        layout.descriptionId[room] = descriptionId;
+    }
+    void setTreasureSpan(RoomId room, uint32_t begin, uint16_t count) {
+        edit().treasureBegin[room] = begin;
+        treasureCount_[room] = count;
+    }
+    void setEnemySpan(RoomId room, uint32_t begin, uint16_t count) {
+        Layout& layout = edit();
+        layout.enemyBegin[room] = begin;
+        layout.enemyCount[room] = count;
+    }
+    void setTreasureSlot(size_t slot, ItemId item) { treasureItem_[slot] = item; }
+
+    size_t roomCount() const {
+        return streamed() ? chunks_.file->roomCount() : layout_->nameId.size();
+    }
+
+    const std::string& name(RoomId room) const { return layout_->strings.text(nameId(room)); }
+    uint32_t nameId(RoomId room) const {
+        return streamed() ? chunks_.file->room(room).nameId : layout_->nameId[room];
+    }
+    // Id of a room name, or StringTable::NONE if no room has it
+    uint32_t findName(std::string_view name) const { return layout_->strings.find(name); }
+    const std::string& description(RoomId room) const {
+        return layout_->strings.text(streamed() ? chunks_.file->room(room).descriptionId
+                                                : layout_->descriptionId[room]);
+    }
+
+    RoomId exit(RoomId room, char direction) const {
+        int slot = exitSlot(direction);
+        return slot < 0 ? NO_ROOM : exits(room)[slot];
+    }
+    // By value: a streamed room can be evicted while the caller looks at another one
+    std::array<RoomId, EXIT_SLOTS> exits(RoomId room) const {
+        return streamed() ? chunks_.file->room(room).exits : layout_->exits[room];
+    }
+
+    uint32_t enemyBegin(RoomId room) const {
+        return streamed() ? chunks_.file->room(room).enemyBegin : layout_->enemyBegin[room];
+    }
+    size_t enemyCount(RoomId room) const {
+        return streamed() ? chunks_.file->room(room).enemyCount : layout_->enemyCount[room];
+    }
+
+    bool visited(RoomId room) const {
+        return (streamed() ? chunks_.file->room(room).visited : visited_[room]) != 0;
+    }
+    void markVisited(RoomId room) {
+        if (streamed()) {
+            chunks_.file->roomForWrite(room).visited = 1;
+        } else {
+            visited_[room] = 1;
+        }
+    }
+
+    size_t treasureCount(RoomId room) const {
+        return streamed() ? chunks_.file->room(room).treasureCount : treasureCount_[room];
+    }
+    ItemId treasureItem(RoomId room, size_t i) const {
+        return streamed() ? chunks_.file->item(room, i)
+                          : treasureItem_[layout_->treasureBegin[room] + i];
+    }
+    std::string_view treasureName(RoomId room, size_t i) const {
+        return itemDefinition(treasureItem(room, i)).name;
+    }
+    int treasureValue(RoomId room, size_t i) const {
+        return itemDefinition(treasureItem(room, i)).value;
+    }
+    // Looting empties the span; the slots stay in the flat array
+    void clearTreasure(RoomId room) {
+        if (streamed()) {
+            chunks_.file->roomForWrite(room).treasureCount = 0;
+        } else {
+            treasureCount_[room] = 0;
+        }
+    }
+    // Takes one item out of the span, keeping the others in order
+    void removeTreasure(RoomId room, size_t i) {
+        if (streamed()) {
+            chunks_.file->removeItem(room, i);
+            return;
+        }
+        size_t begin = layout_->treasureBegin[room];
+        size_t count = treasureCount_[room];
+        for (size_t k = begin + i; k + 1 < begin + count; ++k) {
+            treasureItem_[k] = treasureItem_[k + 1];
+        }
+        --treasureCount_[room];
+    }
+
+    // Moves the rooms out to a new chunk file at path, keeping at most residentChunks
+    // chunks of them in memory; false (with the world unchanged) if the file cannot be written
+    bool streamTo(const std::string& path, size_t residentChunks) {
+        assert(!streamed());
+        auto file = std::make_unique<WorldChunks>();
+        if (!file->create(path, residentChunks)) {
+            return false;
+        }
+        const Layout& layout = *layout_;
+        std::vector<WorldChunks::Room> rooms;
+        std::vector<ItemId> items;
+        for (size_t begin = 0; begin < roomCount(); begin += WorldChunks::ROOMS_PER_CHUNK) {
+            size_t end = std::min(begin + WorldChunks::ROOMS_PER_CHUNK, roomCount());
+            rooms.clear();
+            items.clear();
+            for (size_t r = begin; r < end; ++r) {
+                rooms.push_back({layout.nameId[r], layout.descriptionId[r], layout.exits[r],
+                                 layout.enemyBegin[r], layout.enemyCount[r], treasureCount_[r],
+                                 static_cast<uint32_t>(items.size()), visited_[r]});
+                auto span = treasureItem_.begin() + layout.treasureBegin[r];
+                items.insert(items.end(), span, span + treasureCount_[r]);
+            }
+            if (!file->append(rooms, items)) {
+                return false;
+            }
+        }
+        // Only the strings stay; copies of the world that share the layout keep theirs
+        auto strings = std::make_shared<Layout>();
+        strings->strings = layout.strings;
+        layout_ = std::move(strings);
+        visited_ = {};
+        treasureCount_ = {};
+        treasureItem_ = {};
+        chunks_.file = std::move(file);
+        return true;
+    }
+
+    bool streamed() const { return chunks_.file != nullptr; }
+
+    // Loads the chunks behind a room's exits, so walking on from it finds them resident
+    void prefetchExits(RoomId room) const {
+        if (streamed()) {
+            for (RoomId next : exits(room)) {
+                if (next != NO_ROOM) {
+                    chunks_.file->prefetch(next);
+                }
+            }
+        }
+    }
+
+    // Cache counters of a streamed world (all zero for an in-memory one)
+    ChunkCacheStats chunkStats() const {
+        return streamed() ? chunks_.file->stats() : ChunkCacheStats();
+    }
+
+    // Bytes held by the layout (shared or not), the mutable columns and resident chunks
+    // (capacity, not just size)
+    size_t memoryBytes() const { return layoutBytes() + stateBytes(); }
+    size_t layoutBytes() const {
+        const Layout& layout = *layout_;
+        return columnBytes(layout.nameId) + columnBytes(layout.descriptionId) +
+               columnBytes(layout.exits) + columnBytes(layout.enemyBegin) +
+               columnBytes(layout.enemyCount) + columnBytes(layout.treasureBegin) +
+               layout.strings.memoryBytes();
+    }
+    // What this copy of the world owns alone
+    size_t stateBytes() const {
+        return columnBytes(visited_) + columnBytes(treasureCount_) + columnBytes(treasureItem_) +
+               chunkStats().residentBytes;
+    }
+    // True if both are copies of one world definition (or of each other)
+    bool sharesLayoutWith(const WorldStore& other) const { return layout_ == other.layout_; }
+
+    // The routing graph cached for this world's exits, or null; any thread may read it
+    std::shared_ptr<const RouteGraph> cachedRoutes() const { return layout_->routes.get(); }
+    // Shares graph, built from this world's current exits, with every world of this layout
+    void cacheRoutes(std::shared_ptr<const RouteGraph> graph) const {
+        layout_->routes.set(std::move(graph));
+    }
+
+    // Full world state, including what has been visited and looted
+    void writeSnapshot(SnapshotWriter& out) const {
+        layout_->strings.writeSnapshot(out);
+        if (streamed()) {
+            writeStreamedColumns(out);
+            return;
+        }
+        out.putColumn(layout_->nameId);
+        out.putColumn(layout_->descriptionId);
+        out.putColumn(layout_->exits);
+        out.putColumn(layout_->enemyBegin);
+        out.putColumn(layout_->enemyCount);
+        out.putColumn(visited_);
+        out.putColumn(layout_->treasureBegin);
+        out.putColumn(treasureCount_);
+        out.putColumn(treasureItem_);
+    }
+
+    bool readSnapshot(SnapshotReader& in) {
+        chunks_.file.reset();
+        auto layout = std::make_shared<Layout>();
+        if (!layout->strings.readSnapshot(in)) {
+            return false;
+        }
+        bool ok = in.getColumn(layout->nameId) && in.getColumn(layout->descriptionId) &&
+                  in.getColumn(layout->exits) && in.getColumn(layout->enemyBegin) &&
+                  in.getColumn(layout->enemyCount) && in.getColumn(visited_) &&
+                  in.getColumn(layout->treasureBegin) && in.getColumn(treasureCount_) &&
+                  in.getColumn(treasureItem_);
+        layout_ = std::move(layout);
+        return ok && isConsistent();
+    }
+
+   private:
+    // The same columns as an in-memory world, gathered room by room through the cache.
+    // Treasure is packed, leaving out slots that were looted.
+    void writeStreamedColumns(SnapshotWriter& out) const {
+        WorldChunks& file = *chunks_.file;
+        size_t rooms = roomCount();
+        auto column = [&](auto field) {
+            using T = decltype(field(file.room(0)));
+            out.putColumn<T>(rooms, [&](T* values) {
+                for (size_t r = 0; r < rooms; ++r) {
+                    values[r] = field(file.room(static_cast<RoomId>(r)));
+                }
+            });
+        };
+        using Room = WorldChunks::Room;
+        column([](const Room& room) { return room.nameId; });
+        column([](const Room& room) { return room.descriptionId; });
+        column([](const Room& room) { return room.exits; });
+        column([](const Room& room) { return room.enemyBegin; });
+        column([](const Room& room) { return room.enemyCount; });
+        column([](const Room& room) { return room.visited; });
+        uint32_t treasure = 0;
+        column([&treasure](const Room& room) {
+            uint32_t begin = treasure;
+            treasure += room.treasureCount;
+            return begin;
+        });
+        column([](const Room& room) { return room.treasureCount; });
+        out.putColumn<ItemId>(treasure, [&](ItemId* values) {
+            for (size_t r = 0; r < rooms; ++r) {
+                auto room = static_cast<RoomId>(r);
+                for (size_t i = 0; i < file.room(room).treasureCount; ++i) {
+                    *values++ = file.item(room, i);
+                }
+            }
+        });
+    }
+
+    // Cheap structural check after loading; ids must stay in range for the accessors
+    bool isConsistent() const {
+        const Layout& layout = *layout_;
+        size_t rooms = layout.nameId.size();
+        if (layout.descriptionId.size() != rooms || layout.exits.size() != rooms ||
+            layout.enemyBegin.size() != rooms || layout.enemyCount.size() != rooms ||
+            visited_.size() != rooms || layout.treasureBegin.size() != rooms ||
+            treasureCount_.size() != rooms) {
+            return false;
+        }
+        for (size_t r = 0; r < rooms; ++r) {
+            if (layout.nameId[r] >= layout.strings.size() ||
+                layout.descriptionId[r] >= layout.strings.size() ||
+                size_t{layout.treasureBegin[r]} + treasureCount_[r] > treasureItem_.size()) {
+                return false;
+            }
+            for (RoomId target : layout.exits[r]) {
+                if (target < NO_ROOM || target >= static_cast<RoomId>(rooms)) {
+                    return false;
+                }
+            }
+        }
+        for (ItemId item : treasureItem_) {
+            if (item >= ITEM_COUNT) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    static size_t columnBytes(const std::vector<T>& column) {
+        return column.capacity() * sizeof(T);
+    }
+
+    // Owner of a streamed world's chunk file. It can't be copied, and so neither can a
+    // world: copies are made with cloneInMemory().
+    struct ChunkFile {
+        std::unique_ptr<WorldChunks> file;
+    };
+
+    // A routing graph shared through the layout. Copying a layout (to change it) doesn't
+    // copy the graph.
+    class RouteCache {
+       public:
+        RouteCache() = default;
+        RouteCache(const RouteCache&) {}
+        RouteCache& operator=(const RouteCache&) {
+            clear();
+            return *this;
+        }
+
+        std::shared_ptr<const RouteGraph> get() const {
+            return cached_.load(std::memory_order_acquire) ? graph_.load() : nullptr;
+        }
+        void set(std::shared_ptr<const RouteGraph> graph) {
+            graph_.store(std::move(graph));
+            cached_.store(true, std::memory_order_release);
+        }
+        // A plain load when nothing is cached, so concurrent construction can call it freely
+        void clear() {
+            if (cached_.load(std::memory_order_relaxed)) {
+                cached_.store(false, std::memory_order_relaxed);
+                graph_.store(nullptr);
+            }
+        }
+
+       private:
+        std::atomic<bool> cached_{false};
+        std::atomic<std::shared_ptr<const RouteGraph>> graph_;
+    };
+
+    // What play never changes: strings and the per-room columns fixed at construction
+    struct Layout {
+        StringTable strings;
+        std::vector<uint32_t> nameId;
+        std::vector<uint32_t> descriptionId;
+        std::vector<std::array<RoomId, EXIT_SLOTS>> exits;
+        std::vector<uint32_t> enemyBegin;
+        std::vector<uint16_t> enemyCount;
+        std::vector<uint32_t> treasureBegin;
+        RouteCache routes;
+    };
+
+    static const std::shared_ptr<Layout>& emptyLayout() {
+        static const std::shared_ptr<Layout> empty = std::make_shared<Layout>();
+        return empty;
+    }
+
+    // The layout for construction, copied first if another world shares it. Only the owner
+    // can see a use count of 1, so concurrent fills of an unshared world never copy.
+    Layout& edit() {
+        if (layout_.use_count() > 1) {
+            layout_ = std::make_shared<Layout>(*layout_);
+        }
+        return *layout_;
+    }
+
+    // Copying a world shares its layout and copies only the mutable columns below
+    std::shared_ptr<Layout> layout_ = emptyLayout();
+    ChunkFile chunks_;
+
+    // Per-room state
+    std::vector<uint8_t> visited_;
+    std::vector<uint16_t> treasureCount_;
+
+    // Flat treasure storage (looting shifts items within a room's span)
+    std::vector<ItemId> treasureItem_;
+};
@@ -1,10 +1,21 @@
 #include "display.h"
 
+#include <cstring>
+
+#include "bar_renderer.h"
+#include "base_format.h"
+
 void displayBar(int current, int max, int barWidth) {
-    // TODO: Implement progress bar
-    (void)current;
-    (void)max;
-    (void)barWidth;  // Remove when implementing
+    // Rendered into a buffer and written in one piece; only very wide bars need the heap
+    char local[1024];
+    std::string wide;
+    char* text = local;
+    if (bars::barBytes(barWidth) > sizeof(local)) {
+        wide.resize(bars::barBytes(barWidth));
+        text = &wide[0];
+    }
+    char* end = bars::renderBar(text, current, max, barWidth);
+    std::cout.write(text, end - text);
 }
 
 void displayCharacter(const std::string& name, const std::string& charClass, int level, int health,
@@ -17,7 +28,22 @@ void displayCharacter(const std::string& name, const std::string& charClass, int
     (void)maxHealth;
 }
 
+namespace {
+
+char* appendLine(char* out, const char* label, size_t length, int value, bases::Base base) {
+    std::memcpy(out, label, length);
+    out = bases::format(out + length, value, base);
+    *out++ = '\n';
+    return out;
+}
+
+}  // namespace
+
 void displayInBases(int value) {
-    // TODO: Implement base conversion display
-    (void)value;
+    // One buffer and one write; std::cout's base flags are never touched
+    char text[64];
+    char* end = appendLine(text, "Decimal: ", 9, value, bases::Base::Decimal);
+    end = appendLine(end, "Hex:     ", 9, value, bases::Base::Hex);
+    end = appendLine(end, "Octal:   ", 9, value, bases::Base::Octal);
+    std::cout.write(text, end - text);
 }
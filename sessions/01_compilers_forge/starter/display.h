@@ -3,6 +3,9 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <string_view>
+
+#include "type_report.h"
 
 // ============================================================================
 // REQUIRED FUNCTIONS FOR TESTS
@@ -54,11 +57,17 @@ void displayInBases(int value);
  * your own templates in Session 10.
  * 
  * Shows: type name, size in bytes, min value, max value
+ *
+ * The size and limit lines are the same for every call, so they are built at
+ * compile time (game_world/type_report.h): they read exactly as
+ *     std::cout << "  Size: " << sizeof(T) << " bytes\n";
+ *     std::cout << "  Min:  " << std::numeric_limits<T>::min() << "\n";
+ *     std::cout << "  Max:  " << std::numeric_limits<T>::max() << "\n";
+ * would print them, and only the name is formatted at run time.
  */
 template <typename T>
 void displayTypeInfo(const std::string& typeName) {
+    constexpr std::string_view limits = typereport::limitsBlock<T>();
     std::cout << "Type: " << typeName << "\n";
-    std::cout << "  Size: " << sizeof(T) << " bytes\n";
-    std::cout << "  Min:  " << std::numeric_limits<T>::min() << "\n";
-    std::cout << "  Max:  " << std::numeric_limits<T>::max() << "\n";
+    std::cout.write(limits.data(), static_cast<std::streamsize>(limits.size()));
 }